@@ -0,0 +1,337 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "heapUsage.hxx"
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include "treeGenerator.hxx"
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_ST_TREE
+#include "small_memory_tree/stTree.hxx"
+#endif
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_STLPLUS_TREE
+#include "small_memory_tree/stlplusTree.hxx"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Benchmarks construction, lookup and memory of SmallMemoryTree on synthetic trees and compares it with st_tree and stlplus if they are enabled (WITH_ST_TREE, WITH_STLPLUS_TREE).
+Writes one csv line per measurement so results of different commits can be compared to catch regressions:
+generator,nodeCount,library,operation,nanosecondsPerOperation,operationCount,retainedHeapBytes,peakHeapBytes
+retainedHeapBytes is the heap held by the result of the operation. peakHeapBytes is the highest heap usage during the operation. Both are measured with the replaced operator new from heapUsage.cxx.
+*/
+
+namespace
+{
+using ValueType = uint32_t;
+using BenchmarkTree = small_memory_tree::SmallMemoryTree<ValueType, uint32_t>;
+
+struct Options
+{
+  uint64_t maxNodeCount{ 1'000'000 };
+  uint64_t maxComparisonNodeCount{ 1'000'000 };
+  uint64_t lookupCount{ 10'000 };
+  uint64_t repetitions{ 3 };
+  std::chrono::nanoseconds lookupTimeBudget{ std::chrono::milliseconds{ 500 } };
+  std::string outputPath{};
+};
+
+struct Measurement
+{
+  std::string operation{};
+  double nanosecondsPerOperation{};
+  uint64_t operationCount{ 1 };
+  uint64_t retainedHeapBytes{};
+  uint64_t peakHeapBytes{};
+};
+
+struct HeapMeasurement
+{
+  uint64_t retainedHeapBytes{};
+  uint64_t peakHeapBytes{};
+};
+
+// Results of measured work get added so the compiler can not drop the work
+volatile uint64_t sink{};
+
+// st_tree and stlplus destroy their nodes recursively so deeper trees would overflow the stack
+constexpr uint64_t maxComparisonDepth = 10'000;
+
+constexpr uint64_t maxPathLength = 32;
+
+[[nodiscard]] double
+median (std::vector<double> values)
+{
+  std::ranges::sort (values);
+  return values.at (values.size () / 2);
+}
+
+// Median duration in nanoseconds of repetitions calls of function
+template <typename Function>
+[[nodiscard]] double
+medianNanoseconds (uint64_t repetitions, Function const &function)
+{
+  auto durations = std::vector<double>{};
+  for (auto repetition = uint64_t{}; repetition < std::max<uint64_t> (repetitions, 1); ++repetition)
+    {
+      auto const start = std::chrono::steady_clock::now ();
+      sink = sink + function ();
+      durations.push_back (static_cast<double> (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start).count ()));
+    }
+  return median (durations);
+}
+
+// Heap held by the result of function and the peak heap usage while function runs
+template <typename Function>
+[[nodiscard]] HeapMeasurement
+measureHeap (Function const &function)
+{
+  auto const heapBytesBefore = benchmark::currentHeapBytes ();
+  benchmark::resetPeakHeapBytes ();
+  [[maybe_unused]] auto const result = function ();
+  return HeapMeasurement{ benchmark::currentHeapBytes () - heapBytesBefore, benchmark::peakHeapBytes () - heapBytesBefore };
+}
+
+// Time, retained heap and peak heap of building something with function. Function gets called repetitions + 1 times
+template <typename Function>
+[[nodiscard]] Measurement
+measureConstruction (std::string operation, uint64_t repetitions, Function const &function)
+{
+  auto const heapMeasurement = measureHeap (function);
+  auto const nanoseconds = medianNanoseconds (repetitions, [&function] () {
+    [[maybe_unused]] auto const result = function ();
+    return uint64_t{ 1 };
+  });
+  return Measurement{ std::move (operation), nanoseconds, 1, heapMeasurement.retainedHeapBytes, heapMeasurement.peakHeapBytes };
+}
+
+// Calls find (path) for the paths until all paths are done or the time budget is used up. A lookup with an unsorted search on the wide fan trees scans all children
+// so the time budget keeps big trees from running for hours. Returns the median nanoseconds per lookup of all repetitions
+template <typename Find>
+[[nodiscard]] Measurement
+measureLookup (std::string operation, std::vector<std::vector<ValueType> > const &paths, Options const &options, Find const &find)
+{
+  auto nanosecondsPerLookup = std::vector<double>{};
+  auto lookupCount = uint64_t{};
+  for (auto repetition = uint64_t{}; repetition < std::max<uint64_t> (options.repetitions, 1); ++repetition)
+    {
+      auto const start = std::chrono::steady_clock::now ();
+      auto checksum = uint64_t{};
+      lookupCount = 0;
+      for (auto const &path : paths)
+        {
+          checksum += find (path);
+          // reading the clock after every lookup would be measured too
+          if (++lookupCount % 64 == 0 and std::chrono::steady_clock::now () - start > options.lookupTimeBudget) break;
+        }
+      auto const nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start).count ();
+      sink = sink + checksum;
+      nanosecondsPerLookup.push_back (static_cast<double> (nanoseconds) / static_cast<double> (std::max<uint64_t> (lookupCount, 1)));
+    }
+  return Measurement{ std::move (operation), median (nanosecondsPerLookup), lookupCount, 0, 0 };
+}
+
+// Paths to random nodes. Every path walks down from the root picking a random child until it has a random length or reaches a leaf
+[[nodiscard]] std::vector<std::vector<ValueType> >
+randomPaths (BenchmarkTree const &tree, uint64_t pathCount, uint64_t seed = 42)
+{
+  auto randomNumberGenerator = std::mt19937_64{ seed };
+  auto const &values = tree.getValues ();
+  auto paths = std::vector<std::vector<ValueType> > (values.empty () ? 0 : pathCount);
+  for (auto &path : paths)
+    {
+      auto const pathLength = std::uniform_int_distribution<uint64_t>{ 1, maxPathLength }(randomNumberGenerator);
+      auto node = uint64_t{};
+      path.push_back (values.front ());
+      while (path.size () < pathLength)
+        {
+          auto const [childrenBegin, childrenEnd] = small_memory_tree::internals::childrenBeginAndEndIndex (tree, node).value ();
+          if (childrenBegin == childrenEnd) break;
+          node = std::uniform_int_distribution<uint64_t>{ childrenBegin, childrenEnd - 1 }(randomNumberGenerator);
+          path.push_back (values.at (node));
+        }
+    }
+  return paths;
+}
+
+[[nodiscard]] uint64_t
+treeDepth (BenchmarkTree const &tree)
+{
+  if (tree.getValues ().empty ()) return 0;
+  // the nodes of a level are next to each other so the next level starts at the children of the first node and ends at the children of the last node of the level
+  auto depth = uint64_t{ 1 };
+  auto levelBegin = uint64_t{};
+  auto levelEnd = uint64_t{ 1 };
+  while (true)
+    {
+      auto const nextLevelBegin = std::get<0> (small_memory_tree::internals::childrenBeginAndEndIndex (tree, levelBegin).value ());
+      auto const nextLevelEnd = std::get<1> (small_memory_tree::internals::childrenBeginAndEndIndex (tree, levelEnd - 1).value ());
+      if (nextLevelBegin >= nextLevelEnd) return depth;
+      ++depth;
+      levelBegin = nextLevelBegin;
+      levelEnd = nextLevelEnd;
+    }
+}
+
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_ST_TREE
+// Children count of the node path points to. 0 if path does not match
+[[nodiscard]] uint64_t
+stTreeChildrenCountForPath (st_tree::tree<ValueType> const &tree, std::vector<ValueType> const &path, bool sortedNodes)
+{
+  if (tree.empty () or path.empty () or tree.root ().data () != path.front ()) return 0;
+  auto const *node = &tree.root ();
+  for (auto const &value : path | std::views::drop (1))
+    {
+      auto const &data = [] (auto const &child) { return child.data (); };
+      auto const child = sortedNodes ? confu_algorithm::binaryFind (node->begin (), node->end (), value, {}, data) : std::ranges::find (*node, value, data);
+      if (child == node->end ()) return 0;
+      node = &*child;
+    }
+  return node->size ();
+}
+#endif
+
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_STLPLUS_TREE
+[[nodiscard]] uint64_t
+stlplusTreeChildrenCountForPath (stlplus::ntree<ValueType> const &tree, std::vector<ValueType> const &path, bool sortedNodes)
+{
+  if (tree.empty () or path.empty () or tree.root ().node ()->m_data != path.front ()) return 0;
+  auto const *node = tree.root ().node ();
+  for (auto const &value : path | std::views::drop (1))
+    {
+      auto const &children = node->m_children;
+      auto const &data = [] (auto const *child) { return child->m_data; };
+      auto const child = sortedNodes ? confu_algorithm::binaryFind (children.begin (), children.end (), value, {}, data) : std::ranges::find (children, value, data);
+      if (child == children.end ()) return 0;
+      node = *child;
+    }
+  return node->m_children.size ();
+}
+#endif
+
+class CsvWriter
+{
+public:
+  explicit CsvWriter (std::ostream &output_) : output{ &output_ } { *output << std::fixed << std::setprecision (1) << "generator,nodeCount,library,operation,nanosecondsPerOperation,operationCount,retainedHeapBytes,peakHeapBytes\n"; }
+
+  void
+  write (std::string_view generator, uint64_t nodeCount, std::string_view library, Measurement const &measurement)
+  {
+    // flush so results of long runs are not lost if the run gets aborted
+    *output << generator << ',' << nodeCount << ',' << library << ',' << measurement.operation << ',' << measurement.nanosecondsPerOperation << ',' << measurement.operationCount << ',' << measurement.retainedHeapBytes << ',' << measurement.peakHeapBytes << std::endl;
+  }
+
+private:
+  std::ostream *output{};
+};
+
+void
+benchmarkTree (benchmark::SyntheticTree const &syntheticTree, Options const &options, CsvWriter &csvWriter)
+{
+  auto const &generator = syntheticTree.getName ();
+  auto const nodeCount = syntheticTree.nodeCount ();
+  std::cerr << "benchmark " << generator << " with " << nodeCount << " nodes" << std::endl;
+  auto const write = [&] (std::string_view library, Measurement const &measurement) { csvWriter.write (generator, nodeCount, library, measurement); };
+  write ("small_memory_tree", measureConstruction ("construct", options.repetitions, [&syntheticTree] () { return BenchmarkTree{ syntheticTree }; }));
+  auto const tree = BenchmarkTree{ syntheticTree };
+  auto const paths = randomPaths (tree, options.lookupCount);
+  for (auto const sortedNodes : { true, false })
+    {
+      write ("small_memory_tree", measureLookup (sortedNodes ? "lookupSorted" : "lookupUnsorted", paths, options, [&tree, sortedNodes] (std::vector<ValueType> const &path) {
+               auto const &childrenIndex = small_memory_tree::calcChildrenIndexForPath (tree, path, sortedNodes).value_or (std::tuple<uint64_t, uint64_t>{});
+               return std::get<1> (childrenIndex) - std::get<0> (childrenIndex);
+             }));
+    }
+  if (nodeCount > options.maxComparisonNodeCount or treeDepth (tree) > maxComparisonDepth) return;
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_ST_TREE
+  {
+    write ("st_tree", measureConstruction ("generateStTree", options.repetitions, [&tree] () { return small_memory_tree::generateStTree (tree).value (); }));
+    auto const stTree = small_memory_tree::generateStTree (tree).value ();
+    write ("st_tree", measureConstruction ("constructSmallMemoryTree", options.repetitions, [&stTree] () { return BenchmarkTree{ small_memory_tree::StTreeAdapter{ stTree } }; }));
+    if (BenchmarkTree{ small_memory_tree::StTreeAdapter{ stTree } } != tree) throw std::logic_error{ "st_tree round trip changed the tree " + generator };
+    for (auto const sortedNodes : { true, false })
+      {
+        write ("st_tree", measureLookup (sortedNodes ? "lookupSorted" : "lookupUnsorted", paths, options, [&stTree, sortedNodes] (std::vector<ValueType> const &path) { return stTreeChildrenCountForPath (stTree, path, sortedNodes); }));
+      }
+  }
+#endif
+#ifdef SMALL_MEMORY_TREE_BENCHMARK_WITH_STLPLUS_TREE
+  {
+    write ("stlplus", measureConstruction ("generateStlplusTree", options.repetitions, [&tree] () { return small_memory_tree::generateStlplusTree (tree).value (); }));
+    auto const stlplusTree = small_memory_tree::generateStlplusTree (tree).value ();
+    write ("stlplus", measureConstruction ("constructSmallMemoryTree", options.repetitions, [&stlplusTree] () { return BenchmarkTree{ small_memory_tree::StlplusTreeAdapter{ stlplusTree } }; }));
+    if (BenchmarkTree{ small_memory_tree::StlplusTreeAdapter{ stlplusTree } } != tree) throw std::logic_error{ "stlplus round trip changed the tree " + generator };
+    for (auto const sortedNodes : { true, false })
+      {
+        write ("stlplus", measureLookup (sortedNodes ? "lookupSorted" : "lookupUnsorted", paths, options, [&stlplusTree, sortedNodes] (std::vector<ValueType> const &path) { return stlplusTreeChildrenCountForPath (stlplusTree, path, sortedNodes); }));
+      }
+  }
+#endif
+}
+
+void
+printUsage ()
+{
+  std::cerr << "usage: _benchmark [--max-nodes n] [--max-comparison-nodes n] [--lookups n] [--repetitions n] [--lookup-time-budget-ms n] [--output file]\n"
+               "benchmarks trees with 1e3, 1e4, ... nodes up to --max-nodes (default 1e6, at most 1e8). st_tree and stlplus get compared up to --max-comparison-nodes (default 1e6).\n"
+               "Numbers can be written as 1e7.\n";
+}
+}
+
+int
+main (int argc, char **argv)
+{
+  auto options = Options{};
+  auto const arguments = std::vector<std::string_view> (argv + 1, argv + argc);
+  for (auto argument = arguments.begin (); argument != arguments.end (); ++argument)
+    {
+      if (*argument == "--help" or argument + 1 == arguments.end ())
+        {
+          printUsage ();
+          return (*argument == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+      auto const value = std::string{ *++argument };
+      auto const number = [&value] () { return static_cast<uint64_t> (std::stod (value)); };
+      if (argument[-1] == "--max-nodes") options.maxNodeCount = number ();
+      else if (argument[-1] == "--max-comparison-nodes")
+        options.maxComparisonNodeCount = number ();
+      else if (argument[-1] == "--lookups")
+        options.lookupCount = number ();
+      else if (argument[-1] == "--repetitions")
+        options.repetitions = number ();
+      else if (argument[-1] == "--lookup-time-budget-ms")
+        options.lookupTimeBudget = std::chrono::milliseconds{ number () };
+      else if (argument[-1] == "--output")
+        options.outputPath = value;
+      else
+        {
+          printUsage ();
+          return EXIT_FAILURE;
+        }
+    }
+  auto outputFile = std::ofstream{};
+  if (not options.outputPath.empty ()) outputFile.open (options.outputPath);
+  auto csvWriter = CsvWriter{ options.outputPath.empty () ? std::cout : outputFile };
+  for (auto nodeCount = uint64_t{ 1'000 }; nodeCount <= std::min<uint64_t> (options.maxNodeCount, 100'000'000); nodeCount *= 10)
+    {
+      for (auto const &generateTree : std::vector<std::function<benchmark::SyntheticTree (uint64_t)> >{ benchmark::chainTree, benchmark::wideFanTree, [] (uint64_t count) { return benchmark::balancedTree (count, 2); }, [] (uint64_t count) { return benchmark::balancedTree (count, 16); }, [] (uint64_t count) { return benchmark::randomTree (count); }, [] (uint64_t count) { return benchmark::skewedTree (count); } })
+        {
+          benchmarkTree (generateTree (nodeCount), options, csvWriter);
+        }
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "heapUsage.hxx"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+// the size of an allocation gets stored in front of it. Keeps the memory returned to the caller aligned like malloc does
+constexpr std::size_t headerSize = alignof (std::max_align_t);
+
+std::atomic<uint64_t> currentBytes{};
+std::atomic<uint64_t> peakBytes{};
+
+void *
+allocate (std::size_t size) noexcept
+{
+  auto *block = static_cast<std::byte *> (std::malloc (size + headerSize));
+  if (block == nullptr) return nullptr;
+  std::memcpy (block, &size, sizeof (size));
+  auto const current = currentBytes.fetch_add (size) + size;
+  auto peak = peakBytes.load ();
+  while (current > peak and not peakBytes.compare_exchange_weak (peak, current))
+    {
+    }
+  return block + headerSize;
+}
+
+void
+deallocate (void *memory) noexcept
+{
+  if (memory == nullptr) return;
+  auto *block = static_cast<std::byte *> (memory) - headerSize;
+  auto size = std::size_t{};
+  std::memcpy (&size, block, sizeof (size));
+  currentBytes.fetch_sub (size);
+  std::free (block);
+}
+}
+
+uint64_t
+benchmark::currentHeapBytes ()
+{
+  return currentBytes.load ();
+}
+
+uint64_t
+benchmark::peakHeapBytes ()
+{
+  return peakBytes.load ();
+}
+
+void
+benchmark::resetPeakHeapBytes ()
+{
+  peakBytes.store (currentBytes.load ());
+}
+
+// operator new[] and operator delete[] call these. Over aligned allocations (std::align_val_t) are not counted
+void *
+operator new (std::size_t size)
+{
+  if (auto *memory = allocate (size == 0 ? 1 : size)) return memory;
+  throw std::bad_alloc{};
+}
+
+void *
+operator new (std::size_t size, std::nothrow_t const &) noexcept
+{
+  return allocate (size == 0 ? 1 : size);
+}
+
+void
+operator delete (void *memory) noexcept
+{
+  deallocate (memory);
+}
+
+void
+operator delete (void *memory, std::size_t) noexcept
+{
+  deallocate (memory);
+}
+
+void
+operator delete (void *memory, std::nothrow_t const &) noexcept
+{
+  deallocate (memory);
+}
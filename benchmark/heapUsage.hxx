@@ -0,0 +1,19 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+
+namespace benchmark
+{
+// Bytes currently allocated with the global operator new. Replaced operator new lives in heapUsage.cxx
+uint64_t currentHeapBytes ();
+
+// Highest value of currentHeapBytes since the last resetPeakHeapBytes
+uint64_t peakHeapBytes ();
+
+void resetPeakHeapBytes ();
+}
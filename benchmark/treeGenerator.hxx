@@ -0,0 +1,129 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchmark
+{
+/*
+Synthetic tree given by the children count of every node in breadth first order. Is a BreadthFirstSource (see IsBreadthFirstSource) so SmallMemoryTree can be build from it directly.
+The value of a node is its position among its siblings so the children of every node are sorted and the same tree can be searched with sortedNodes true and false.
+The children counts get generated up front so construction benchmarks measure only the construction.
+*/
+class SyntheticTree
+{
+public:
+  SyntheticTree (std::string name_, std::vector<uint32_t> childrenCounts_) : name{ std::move (name_) }, childrenCounts{ std::move (childrenCounts_) } {}
+
+  [[nodiscard]] std::string const &
+  getName () const
+  {
+    return name;
+  }
+
+  [[nodiscard]] uint64_t
+  nodeCount () const
+  {
+    return childrenCounts.size ();
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    if (childrenCounts.empty ()) return;
+    visitor (uint32_t{}, childrenCounts.front ());
+    // node is child childPosition of parent. Both walk through the nodes in breadth first order so no queue is needed
+    auto parent = uint64_t{};
+    auto childPosition = uint32_t{};
+    for (auto node = uint64_t{ 1 }; node < childrenCounts.size (); ++node)
+      {
+        while (childPosition == childrenCounts[parent])
+          {
+            ++parent;
+            childPosition = 0;
+          }
+        visitor (childPosition++, childrenCounts[node]);
+      }
+  }
+
+private:
+  std::string name{};
+  std::vector<uint32_t> childrenCounts{};
+};
+
+namespace internals
+{
+// Calls childrenCount (nodesLeft) for every node in breadth first order until nodeCount nodes exist. The result gets clamped so the tree has exactly nodeCount nodes
+// and gets at least one child if the node is the last one which can still get children
+template <typename ChildrenCount>
+[[nodiscard]] std::vector<uint32_t>
+generateChildrenCounts (uint64_t nodeCount, ChildrenCount &&childrenCount)
+{
+  auto childrenCounts = std::vector<uint32_t>{};
+  if (nodeCount == 0) return childrenCounts;
+  childrenCounts.reserve (nodeCount);
+  auto createdNodeCount = uint64_t{ 1 };
+  for (auto node = uint64_t{}; node < createdNodeCount; ++node)
+    {
+      auto const nodesLeft = nodeCount - createdNodeCount;
+      auto count = std::min<uint64_t> (childrenCount (nodesLeft), nodesLeft);
+      if (count == 0 and nodesLeft != 0 and node + 1 == createdNodeCount) count = 1;
+      childrenCounts.push_back (static_cast<uint32_t> (count));
+      createdNodeCount += count;
+    }
+  return childrenCounts;
+}
+}
+
+// Every node has one child. Depth is nodeCount
+inline SyntheticTree
+chainTree (uint64_t nodeCount)
+{
+  return SyntheticTree{ "chain", internals::generateChildrenCounts (nodeCount, [] (uint64_t) { return uint64_t{ 1 }; }) };
+}
+
+// Root with nodeCount - 1 children
+inline SyntheticTree
+wideFanTree (uint64_t nodeCount)
+{
+  return SyntheticTree{ "wideFan", internals::generateChildrenCounts (nodeCount, [] (uint64_t nodesLeft) { return nodesLeft; }) };
+}
+
+// Every node has childrenCount children until nodeCount is reached
+inline SyntheticTree
+balancedTree (uint64_t nodeCount, uint64_t childrenCount)
+{
+  return SyntheticTree{ "balanced" + std::to_string (childrenCount) + "ary", internals::generateChildrenCounts (nodeCount, [childrenCount] (uint64_t) { return childrenCount; }) };
+}
+
+// Children counts are uniform distributed from 0 to 4
+inline SyntheticTree
+randomTree (uint64_t nodeCount, uint64_t seed = 42)
+{
+  auto randomNumberGenerator = std::mt19937_64{ seed };
+  return SyntheticTree{ "random", internals::generateChildrenCounts (nodeCount, [&randomNumberGenerator] (uint64_t) { return std::uniform_int_distribution<uint64_t>{ 0, 4 }(randomNumberGenerator); }) };
+}
+
+// Children counts follow a pareto distribution so most nodes have no or few children and some nodes have thousands
+inline SyntheticTree
+skewedTree (uint64_t nodeCount, uint64_t seed = 42)
+{
+  auto randomNumberGenerator = std::mt19937_64{ seed };
+  return SyntheticTree{ "skewed", internals::generateChildrenCounts (nodeCount, [&randomNumberGenerator] (uint64_t nodesLeft) {
+                          auto const uniform = std::uniform_real_distribution<double>{ std::numeric_limits<double>::min (), 1 }(randomNumberGenerator);
+                          return static_cast<uint64_t> (std::min (std::pow (uniform, -1 / 1.2) - 1, static_cast<double> (nodesLeft)));
+                        }) };
+}
+}
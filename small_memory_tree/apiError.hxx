@@ -8,7 +8,14 @@ enum class ApiError
   OutOfRange = 1,
   EmptyPath,
   PathTooLong,
-  PathDoesNotMatch
+  PathDoesNotMatch,
+  InvalidFileFormat,
+  UnsupportedFileVersion,
+  ByteOrderMismatch,
+  TypeMismatch,
+  Misaligned,
+  RootHasNoParent,
+  ConflictingEdits
 };
 class ApiErrorCategoryImpl : public std::error_category
 {
@@ -31,6 +38,20 @@ public:
         return "Path does not match";
       case ApiError::EmptyPath:
         return "Empty Path is not allowed";
+      case ApiError::InvalidFileFormat:
+        return "Invalid file format";
+      case ApiError::UnsupportedFileVersion:
+        return "Unsupported file version";
+      case ApiError::ByteOrderMismatch:
+        return "Byte order of the file does not match the byte order of the machine";
+      case ApiError::TypeMismatch:
+        return "Type stored in the file does not match the requested type";
+      case ApiError::Misaligned:
+        return "Data is not aligned for the requested type";
+      case ApiError::RootHasNoParent:
+        return "Root has no parent";
+      case ApiError::ConflictingEdits:
+        return "Edits change the same node or a node which gets removed";
       default:
         return "Unknown Api Error";
       }
@@ -0,0 +1,171 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace small_memory_tree
+{
+// SmallMemoryTree with the narrowest ChildrenOffsetEndType which can hold the tree. Created by compact or makeCompactSmallMemoryTree.
+// calcChildrenIndexForPath, calcChildrenSpanForPath and calcChildrenForPath dispatch once per query to the stored SmallMemoryTree.
+template <typename ValueType> using CompactSmallMemoryTree = std::variant<SmallMemoryTree<ValueType, uint8_t>, SmallMemoryTree<ValueType, uint16_t>, SmallMemoryTree<ValueType, uint32_t>, SmallMemoryTree<ValueType, uint64_t> >;
+
+namespace internals
+{
+// Calls function with a default constructed value of the narrowest unsigned type which can hold maxValue
+template <typename Function>
+[[nodiscard]] decltype (auto)
+visitNarrowestUnsignedType (uint64_t maxValue, Function &&function)
+{
+  if (maxValue <= std::numeric_limits<uint8_t>::max ()) return function (uint8_t{});
+  else if (maxValue <= std::numeric_limits<uint16_t>::max ())
+    return function (uint16_t{});
+  else if (maxValue <= std::numeric_limits<uint32_t>::max ())
+    return function (uint32_t{});
+  else
+    return function (uint64_t{});
+}
+
+template <typename To, std::ranges::input_range Range>
+[[nodiscard]] std::expected<std::vector<To>, std::error_condition>
+convertElements (Range const &range)
+{
+  auto result = std::vector<To>{};
+  if constexpr (std::ranges::sized_range<Range>) result.reserve (std::ranges::size (range));
+  for (auto const &element : range)
+    {
+      if constexpr (std::integral<To> and std::integral<std::ranges::range_value_t<Range> >)
+        {
+          if (not std::in_range<To> (element)) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+        }
+      result.push_back (static_cast<To> (element));
+    }
+  return result;
+}
+}
+
+// Copies smallMemoryTree into a SmallMemoryTree with ChildrenOffsetEndType NewChildrenOffsetEndType. Returns ApiError::OutOfRange if an element of childrenOffsetEnds does not fit.
+template <typename NewChildrenOffsetEndType, internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<SmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType>, NewChildrenOffsetEndType>, std::error_condition>
+convertChildrenOffsetEndType (SmallMemoryTreeType const &smallMemoryTree)
+{
+  auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+  auto newChildrenOffsetEnds = std::vector<NewChildrenOffsetEndType>{};
+  newChildrenOffsetEnds.reserve (childrenOffsetEnds.size ());
+  for (auto i = uint64_t{}; i < childrenOffsetEnds.size (); ++i)
+    {
+      if (not std::in_range<NewChildrenOffsetEndType> (childrenOffsetEnds[i])) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+      newChildrenOffsetEnds.push_back (static_cast<NewChildrenOffsetEndType> (childrenOffsetEnds[i]));
+    }
+  auto const &values = smallMemoryTree.getValues ();
+  return SmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType>, NewChildrenOffsetEndType>{ std::vector<internals::ValueTypeOf<SmallMemoryTreeType> > (std::ranges::begin (values), std::ranges::end (values)), std::move (newChildrenOffsetEnds) };
+}
+
+// Same as convertChildrenOffsetEndType for the values. For integral types ApiError::OutOfRange gets returned if a value does not fit.
+// The ValueType is part of the api (paths use it) so the value width is not picked automatically.
+template <typename NewValueType, internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<SmallMemoryTree<NewValueType, internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType> >, std::error_condition>
+convertValueType (SmallMemoryTreeType const &smallMemoryTree)
+{
+  using ChildrenOffsetEndType = internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType>;
+  if (auto newValuesExpected = internals::convertElements<NewValueType> (smallMemoryTree.getValues ()))
+    {
+      auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+      auto newChildrenOffsetEnds = std::vector<ChildrenOffsetEndType> (childrenOffsetEnds.size ());
+      for (auto i = uint64_t{}; i < childrenOffsetEnds.size (); ++i)
+        {
+          newChildrenOffsetEnds[i] = childrenOffsetEnds[i];
+        }
+      return SmallMemoryTree<NewValueType, ChildrenOffsetEndType>{ std::move (newValuesExpected.value ()), std::move (newChildrenOffsetEnds) };
+    }
+  else
+    {
+      return std::unexpected (newValuesExpected.error ());
+    }
+}
+
+// Copies smallMemoryTree into a SmallMemoryTree with the narrowest ChildrenOffsetEndType which can hold the biggest element of childrenOffsetEnds
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] CompactSmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType> >
+compact (SmallMemoryTreeType const &smallMemoryTree)
+{
+  auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+  auto maxChildrenOffsetEnd = uint64_t{};
+  for (auto i = uint64_t{}; i < childrenOffsetEnds.size (); ++i)
+    {
+      maxChildrenOffsetEnd = std::max (maxChildrenOffsetEnd, boost::numeric_cast<uint64_t> (childrenOffsetEnds[i]));
+    }
+  return internals::visitNarrowestUnsignedType (maxChildrenOffsetEnd, [&smallMemoryTree]<typename ChildrenOffsetEndType> (ChildrenOffsetEndType) {
+    // can not fail because every element fits
+    return CompactSmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType> >{ convertChildrenOffsetEndType<ChildrenOffsetEndType> (smallMemoryTree).value () };
+  });
+}
+
+// Measures the tree and builds the SmallMemoryTree with the narrowest ChildrenOffsetEndType.
+// If the source knows its nodeCount the narrowest type is known up front and the tree gets build only once.
+template <typename ValueType, typename TreeAdapter>
+requires internals::HasIteratorToNode<TreeAdapter> or internals::IsBreadthFirstSource<TreeAdapter>
+[[nodiscard]] CompactSmallMemoryTree<ValueType>
+makeCompactSmallMemoryTree (TreeAdapter const &treeAdapter)
+{
+  if constexpr (requires { treeAdapter.nodeCount (); })
+    {
+      // the biggest childrenOffsetEnd is the index of the last node
+      auto const &nodeCount = boost::numeric_cast<uint64_t> (treeAdapter.nodeCount ());
+      return internals::visitNarrowestUnsignedType ((nodeCount == 0) ? 0 : nodeCount - 1, [&treeAdapter]<typename ChildrenOffsetEndType> (ChildrenOffsetEndType) { return CompactSmallMemoryTree<ValueType>{ SmallMemoryTree<ValueType, ChildrenOffsetEndType>{ treeAdapter } }; });
+    }
+  else
+    {
+      return compact (SmallMemoryTree<ValueType>{ treeAdapter });
+    }
+}
+
+template <typename ValueType, std::ranges::input_range Path, internals::IsChildSearchFor<SmallMemoryTree<ValueType> > ChildSearch = bool>
+[[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
+calcChildrenIndexForPath (CompactSmallMemoryTree<ValueType> const &compactSmallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  return std::visit ([&] (auto const &smallMemoryTree) { return calcChildrenIndexForPath (smallMemoryTree, path, childSearch); }, compactSmallMemoryTree);
+}
+
+template <typename ValueType, internals::IsChildSearchFor<SmallMemoryTree<ValueType> > ChildSearch = bool>
+[[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
+calcChildrenIndexForPath (CompactSmallMemoryTree<ValueType> const &compactSmallMemoryTree, std::initializer_list<std::type_identity_t<ValueType> > path, ChildSearch const &childSearch = false)
+{
+  return calcChildrenIndexForPath (compactSmallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+
+template <typename ValueType, std::ranges::input_range Path, internals::IsChildSearchFor<SmallMemoryTree<ValueType> > ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<ValueType const>, std::error_condition>
+calcChildrenSpanForPath (CompactSmallMemoryTree<ValueType> const &compactSmallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  return std::visit ([&] (auto const &smallMemoryTree) { return calcChildrenSpanForPath (smallMemoryTree, path, childSearch); }, compactSmallMemoryTree);
+}
+
+template <typename ValueType, internals::IsChildSearchFor<SmallMemoryTree<ValueType> > ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<ValueType const>, std::error_condition>
+calcChildrenSpanForPath (CompactSmallMemoryTree<ValueType> const &compactSmallMemoryTree, std::initializer_list<std::type_identity_t<ValueType> > path, ChildSearch const &childSearch = false)
+{
+  return calcChildrenSpanForPath (compactSmallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+
+template <typename ValueType, internals::IsChildSearchFor<SmallMemoryTree<ValueType> > ChildSearch = bool>
+[[nodiscard]] std::expected<std::vector<ValueType>, std::error_condition>
+calcChildrenForPath (CompactSmallMemoryTree<ValueType> const &compactSmallMemoryTree, std::vector<ValueType> const &path, ChildSearch const &childSearch = false)
+{
+  return std::visit ([&] (auto const &smallMemoryTree) { return calcChildrenForPath (smallMemoryTree, path, childSearch); }, compactSmallMemoryTree);
+}
+}
@@ -0,0 +1,148 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace small_memory_tree
+{
+/*
+Child search for trees with sorted children. Can be passed to calcChildrenForPath instead of sortedNodes = true.
+Binary find on a big node costs one cache miss per probe. EytzingerIndex splits the children of every node with at least minChildrenCount children
+into blocks of BlockSize elements (one cache line) and stores the first value of every block in Eytzinger order (breadth first order of a binary search tree).
+A lookup finds the samples of a node with a binary find over the indexed nodes, walks the Eytzinger array without branches while prefetching the next levels and then scans the block the value can be in.
+Like binary find the first child equal to valueToLookFor is returned so the index gives the same results as sortedNodes = true, also for duplicate children.
+The SmallMemoryTree is not changed so children are still returned in their logical order. The index has to be rebuild if the tree changes.
+Only nodes with at least minChildrenCount children are indexed. They cost 8 bytes each for the node to samples lookup plus the samples, other nodes cost nothing.
+Nodes with fewer children skip the lookup.
+*/
+template <typename ValueType, uint64_t BlockSize = std::max<uint64_t> (1, 64 / sizeof (ValueType))> class EytzingerIndex
+{
+public:
+  EytzingerIndex () = default;
+
+  template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+  explicit EytzingerIndex (SmallMemoryTreeType const &smallMemoryTree, uint64_t minChildrenCount_ = 4 * BlockSize) : minChildrenCount{ std::max<uint64_t> (minChildrenCount_, 1) }
+  {
+    static_assert (std::same_as<internals::ValueTypeOf<SmallMemoryTreeType>, ValueType>);
+    auto const &values = std::span{ smallMemoryTree.getValues () };
+    for (auto nodeIndex = uint64_t{}; nodeIndex < values.size (); ++nodeIndex)
+      {
+        if (auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (smallMemoryTree, nodeIndex))
+          {
+            auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+            auto const &children = values.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+            // unsorted children can not be searched with an index. Lookups for them fall back to binary find like sortedNodes = true
+            if (children.size () >= minChildrenCount and std::ranges::is_sorted (children)) addNode (childrenBeginIndex, children);
+          }
+      }
+    childrenBeginIndexes.shrink_to_fit ();
+    samplesBegins.shrink_to_fit ();
+    samples.shrink_to_fit ();
+    blocks.shrink_to_fit ();
+  }
+
+  // Index of the child with valueToLookFor in values[childrenBeginIndex, childrenEndIndex) or childrenEndIndex if there is none
+  template <typename ValueToLookFor>
+  [[nodiscard]] uint64_t
+  findChild (std::span<ValueType const> values, uint64_t childrenBeginIndex, uint64_t childrenEndIndex, ValueToLookFor const &valueToLookFor) const
+  {
+    auto const &children = values.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+    // childrenBeginIndexes is sorted because the nodes get indexed in breadth first order
+    auto const &indexedNode = (children.size () < minChildrenCount) ? childrenBeginIndexes.end () : confu_algorithm::binaryFind (childrenBeginIndexes.begin (), childrenBeginIndexes.end (), childrenBeginIndex);
+    if (indexedNode == childrenBeginIndexes.end ())
+      {
+        return childrenBeginIndex + static_cast<uint64_t> (std::distance (children.begin (), confu_algorithm::binaryFind (children.begin (), children.end (), valueToLookFor)));
+      }
+    auto const &indexedNodeNumber = static_cast<uint64_t> (std::distance (childrenBeginIndexes.begin (), indexedNode));
+    auto const &samplesBegin = samplesBegins[indexedNodeNumber];
+    auto const &sampleCount = samplesBegins[indexedNodeNumber + 1] - samplesBegin - 1;
+    // Eytzinger arrays start at 1. Slot 0 of every node is unused
+    auto const *nodeSamples = samples.data () + samplesBegin;
+    auto const *nodeBlocks = blocks.data () + samplesBegin;
+    auto eytzingerIndex = uint64_t{ 1 };
+    while (eytzingerIndex <= sampleCount)
+      {
+        internals::prefetch (nodeSamples + std::min (eytzingerIndex * prefetchDistance, sampleCount));
+        internals::prefetch (nodeSamples + std::min (eytzingerIndex * prefetchDistance + samplesPerCacheLine, sampleCount));
+        eytzingerIndex = 2 * eytzingerIndex + static_cast<uint64_t> (nodeSamples[eytzingerIndex] < valueToLookFor);
+      }
+    // eytzingerIndex now encodes the path down the tree. Removing the trailing right turns and the last left turn gives the first sample not smaller than valueToLookFor
+    eytzingerIndex >>= std::countr_one (eytzingerIndex) + 1;
+    auto const &firstNotSmallerBlock = (eytzingerIndex == 0) ? sampleCount : uint64_t{ nodeBlocks[eytzingerIndex] };
+    // the first child equal to valueToLookFor is in the block before firstNotSmallerBlock or it is the first child of firstNotSmallerBlock
+    if (firstNotSmallerBlock != 0)
+      {
+        auto const &blockBegin = (firstNotSmallerBlock - 1) * BlockSize;
+        auto const &block = children.subspan (blockBegin, std::min (BlockSize, children.size () - blockBegin));
+        if (auto const &childIndexInBlock = internals::findIndex (block, valueToLookFor); childIndexInBlock != block.size ()) return childrenBeginIndex + blockBegin + childIndexInBlock;
+      }
+    if (firstNotSmallerBlock != sampleCount and children[firstNotSmallerBlock * BlockSize] == valueToLookFor) return childrenBeginIndex + firstNotSmallerBlock * BlockSize;
+    return childrenEndIndex;
+  }
+
+  // Number of nodes which use the index
+  [[nodiscard]] uint64_t
+  indexedNodeCount () const
+  {
+    return childrenBeginIndexes.size ();
+  }
+
+  // Heap memory used by the index in bytes
+  [[nodiscard]] uint64_t
+  memoryUsage () const
+  {
+    return childrenBeginIndexes.capacity () * sizeof (uint64_t) + samplesBegins.capacity () * sizeof (uint64_t) + samples.capacity () * sizeof (ValueType) + blocks.capacity () * sizeof (uint32_t);
+  }
+
+private:
+  static constexpr uint64_t samplesPerCacheLine = std::bit_floor (std::max<uint64_t> (1, 64 / sizeof (ValueType)));
+  // the descendants of eytzingerIndex log2 (prefetchDistance) levels down are next to each other starting at eytzingerIndex * prefetchDistance.
+  // They fill two cache lines which get prefetched together
+  static constexpr uint64_t prefetchDistance = 2 * samplesPerCacheLine;
+
+  void
+  addNode (uint64_t childrenBeginIndex, std::span<ValueType const> children)
+  {
+    auto const &sampleCount = (children.size () + BlockSize - 1) / BlockSize;
+    if (sampleCount > std::numeric_limits<uint32_t>::max ()) return;
+    if (samplesBegins.empty ()) samplesBegins.push_back (0);
+    childrenBeginIndexes.push_back (childrenBeginIndex);
+    auto const &samplesBegin = samples.size ();
+    samples.resize (samplesBegin + sampleCount + 1);
+    blocks.resize (samplesBegin + sampleCount + 1);
+    auto nextBlock = uint64_t{};
+    fillEytzinger (children, samplesBegin, sampleCount, 1, nextBlock);
+    samplesBegins.push_back (samples.size ());
+  }
+
+  // in order traversal of the implicit binary tree assigns the sorted samples to the Eytzinger positions
+  void
+  fillEytzinger (std::span<ValueType const> children, uint64_t samplesBegin, uint64_t sampleCount, uint64_t eytzingerIndex, uint64_t &nextBlock)
+  {
+    if (eytzingerIndex <= sampleCount)
+      {
+        fillEytzinger (children, samplesBegin, sampleCount, 2 * eytzingerIndex, nextBlock);
+        samples.at (samplesBegin + eytzingerIndex) = children[nextBlock * BlockSize];
+        blocks.at (samplesBegin + eytzingerIndex) = static_cast<uint32_t> (nextBlock);
+        ++nextBlock;
+        fillEytzinger (children, samplesBegin, sampleCount, 2 * eytzingerIndex + 1, nextBlock);
+      }
+  }
+
+  uint64_t minChildrenCount{ 1 };
+  std::vector<uint64_t> childrenBeginIndexes{}; // childrenBeginIndex of indexed node i
+  std::vector<uint64_t> samplesBegins{};        // samples of indexed node i are in [samplesBegins[i], samplesBegins[i + 1])
+  std::vector<ValueType> samples{};      // first value of every block in Eytzinger order
+  std::vector<uint32_t> blocks{};        // block number of samples[i]. Only read once per lookup so it is kept out of samples
+};
+}
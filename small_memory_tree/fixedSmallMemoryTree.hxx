@@ -0,0 +1,196 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace small_memory_tree
+{
+// Nested description of a tree. For example TreeLiteral<int>{ 0, { { 1, { { 3 }, { 4 } } }, { 2 } } } is the root 0 with the children 1 and 2 where 1 has the children 3 and 4.
+// children points to the arrays of the braced initializer so a TreeLiteral has to be used in the expression which creates it or be a constexpr variable.
+template <typename ValueType> struct TreeLiteral
+{
+  ValueType value{};
+  std::initializer_list<TreeLiteral> children{};
+
+  [[nodiscard]] constexpr uint64_t
+  nodeCount () const
+  {
+    auto result = uint64_t{ 1 };
+    for (auto const &child : children)
+      {
+        result += child.nodeCount ();
+      }
+    return result;
+  }
+};
+
+namespace internals
+{
+template <uint64_t MaxValue> using NarrowestUnsignedType = std::conditional_t<MaxValue <= std::numeric_limits<uint8_t>::max (), uint8_t, std::conditional_t<MaxValue <= std::numeric_limits<uint16_t>::max (), uint16_t, std::conditional_t<MaxValue <= std::numeric_limits<uint32_t>::max (), uint32_t, uint64_t> > >;
+}
+
+/*
+SmallMemoryTree with the node count fixed at compile time and std::array storage. A constexpr FixedSmallMemoryTree gets build by the compiler and is stored in read only memory.
+The default ChildrenOffsetEndType is the narrowest unsigned type which can hold NodeCount - 1.
+calcChildrenIndexForPath, calcChildrenSpanForPath and calcChildrenForPath are constexpr for FixedSmallMemoryTree. Because std::error_condition can not be created in a constant expression they return ApiError as error.
+All other functions which take an IsSmallMemoryTree work on FixedSmallMemoryTree at runtime.
+*/
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType = internals::NarrowestUnsignedType<(NodeCount == 0) ? 0 : NodeCount - 1> > class FixedSmallMemoryTree
+{
+  // the biggest childrenOffsetEnd of a tree is NodeCount - 1
+  static_assert (NodeCount == 0 or std::cmp_less_equal (NodeCount - 1, std::numeric_limits<ChildrenOffsetEndType>::max ()), "ChildrenOffsetEndType can not hold NodeCount - 1");
+
+public:
+  constexpr FixedSmallMemoryTree () = default;
+
+  constexpr FixedSmallMemoryTree (std::array<ValueType, NodeCount> const &values_, std::array<ChildrenOffsetEndType, NodeCount> const &childrenOffsetEnds_) : values{ values_ }, childrenOffsetEnds{ childrenOffsetEnds_ } {}
+
+  // Throws std::logic_error if treeLiteral does not have NodeCount nodes. In a constant expression this is a compile error
+  constexpr explicit FixedSmallMemoryTree (TreeLiteral<ValueType> const &treeLiteral)
+  requires (NodeCount != 0)
+  {
+    // values get written in breadth first order. nodes is the queue of the breadth first traversal
+    auto nodes = std::array<TreeLiteral<ValueType> const *, NodeCount>{};
+    auto queuedNodeCount = uint64_t{ 1 };
+    nodes.front () = &treeLiteral;
+    auto childrenSum = uint64_t{};
+    for (auto index = uint64_t{}; index < queuedNodeCount; ++index)
+      {
+        auto const &node = *nodes[index];
+        values[index] = node.value;
+        for (auto const &child : node.children)
+          {
+            if (queuedNodeCount == NodeCount) throw std::logic_error{ "TreeLiteral has more nodes than NodeCount" };
+            nodes[queuedNodeCount++] = &child;
+          }
+        childrenSum += node.children.size ();
+        childrenOffsetEnds[index] = static_cast<ChildrenOffsetEndType> (childrenSum);
+      }
+    if (queuedNodeCount != NodeCount) throw std::logic_error{ "TreeLiteral has less nodes than NodeCount" };
+  }
+
+  // clang-format off
+    [[nodiscard]]
+  constexpr auto operator<=> (const FixedSmallMemoryTree &) const = default;
+  // clang-format on
+
+  // Spans with dynamic extent like SmallMemoryTreeView so the lookup functions get the same types for every tree
+  [[nodiscard]] constexpr std::span<ValueType const>
+  getValues () const
+  {
+    return values;
+  }
+
+  [[nodiscard]] constexpr std::span<ChildrenOffsetEndType const>
+  getChildrenOffsetEnds () const
+  {
+    return childrenOffsetEnds;
+  }
+
+private:
+  std::array<ValueType, NodeCount> values{};
+  std::array<ChildrenOffsetEndType, NodeCount> childrenOffsetEnds{};
+};
+
+template <typename ValueType, size_t NodeCount, typename ChildrenOffsetEndType> FixedSmallMemoryTree (std::array<ValueType, NodeCount>, std::array<ChildrenOffsetEndType, NodeCount>) -> FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType>;
+
+// Same as calcChildrenIndexForPath for SmallMemoryTree but constexpr. At runtime the children get searched with internals::findChild so SIMD gets used
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType, std::ranges::input_range Path>
+[[nodiscard]] constexpr std::expected<std::tuple<uint64_t, uint64_t>, ApiError>
+calcChildrenIndexForPath (FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType> const &fixedSmallMemoryTree, Path const &path, bool sortedNodes = false)
+{
+  auto const &values = fixedSmallMemoryTree.getValues ();
+  auto const &childrenOffsetEnds = fixedSmallMemoryTree.getChildrenOffsetEnds ();
+  auto childrenBeginIndex = uint64_t{};
+  auto childrenEndIndex = uint64_t{ 1 }; // the root is the only node on the first level
+  auto pathIsEmpty = true;
+  for (auto const &valueToLookFor : path)
+    {
+      if (pathIsEmpty)
+        {
+          if (values.empty ()) return std::unexpected (ApiError::PathDoesNotMatch);
+          pathIsEmpty = false;
+        }
+      if (childrenBeginIndex == childrenEndIndex) return std::unexpected (ApiError::PathTooLong);
+      auto childIndex = childrenEndIndex;
+      if (std::is_constant_evaluated ())
+        {
+          auto const &children = values.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+          auto const &child = sortedNodes ? std::ranges::lower_bound (children, valueToLookFor) : std::ranges::find (children, valueToLookFor);
+          if (child != children.end () and *child == valueToLookFor) childIndex = childrenBeginIndex + static_cast<uint64_t> (child - children.begin ());
+        }
+      else
+        {
+          childIndex = internals::findChild (sortedNodes, values, childrenBeginIndex, childrenEndIndex, valueToLookFor);
+        }
+      if (childIndex == childrenEndIndex) return std::unexpected (ApiError::PathDoesNotMatch);
+      childrenEndIndex = uint64_t{ childrenOffsetEnds[childIndex] } + 1;
+      childrenBeginIndex = childrenEndIndex - (uint64_t{ childrenOffsetEnds[childIndex] } - ((childIndex == 0) ? uint64_t{} : uint64_t{ childrenOffsetEnds[childIndex - 1] }));
+    }
+  if (pathIsEmpty) return std::unexpected (ApiError::EmptyPath);
+  return std::tuple<uint64_t, uint64_t>{ childrenBeginIndex, childrenEndIndex };
+}
+
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType>
+[[nodiscard]] constexpr std::expected<std::tuple<uint64_t, uint64_t>, ApiError>
+calcChildrenIndexForPath (FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType> const &fixedSmallMemoryTree, std::initializer_list<std::type_identity_t<ValueType> > path, bool sortedNodes = false)
+{
+  return calcChildrenIndexForPath (fixedSmallMemoryTree, std::span{ path.begin (), path.end () }, sortedNodes);
+}
+
+// The span points into fixedSmallMemoryTree. If fixedSmallMemoryTree is constexpr the span can be constexpr too
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType, std::ranges::input_range Path>
+[[nodiscard]] constexpr std::expected<std::span<ValueType const>, ApiError>
+calcChildrenSpanForPath (FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType> const &fixedSmallMemoryTree, Path const &path, bool sortedNodes = false)
+{
+  if (auto const &childrenIndexExpected = calcChildrenIndexForPath (fixedSmallMemoryTree, path, sortedNodes))
+    {
+      auto const &[childrenBeginIndex, childrenEndIndex] = childrenIndexExpected.value ();
+      return fixedSmallMemoryTree.getValues ().subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+    }
+  else
+    {
+      return std::unexpected (childrenIndexExpected.error ());
+    }
+}
+
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType>
+[[nodiscard]] constexpr std::expected<std::span<ValueType const>, ApiError>
+calcChildrenSpanForPath (FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType> const &fixedSmallMemoryTree, std::initializer_list<std::type_identity_t<ValueType> > path, bool sortedNodes = false)
+{
+  return calcChildrenSpanForPath (fixedSmallMemoryTree, std::span{ path.begin (), path.end () }, sortedNodes);
+}
+
+// The returned vector can be used in a constant expression but can not outlive it
+template <typename ValueType, uint64_t NodeCount, typename ChildrenOffsetEndType>
+[[nodiscard]] constexpr std::expected<std::vector<ValueType>, ApiError>
+calcChildrenForPath (FixedSmallMemoryTree<ValueType, NodeCount, ChildrenOffsetEndType> const &fixedSmallMemoryTree, std::vector<std::type_identity_t<ValueType> > const &path, bool sortedNodes = false)
+{
+  if (auto const &childrenExpected = calcChildrenSpanForPath (fixedSmallMemoryTree, path, sortedNodes))
+    {
+      return std::vector<ValueType> (childrenExpected->begin (), childrenExpected->end ());
+    }
+  else
+    {
+      return std::unexpected (childrenExpected.error ());
+    }
+}
+}
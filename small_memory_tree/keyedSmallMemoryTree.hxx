@@ -0,0 +1,208 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace small_memory_tree
+{
+namespace internals
+{
+// Default projections of KeyedSmallMemoryTree for pair like nodes (key, payload)
+struct KeyOfPair
+{
+  template <typename KeyAndPayload>
+  [[nodiscard]] decltype (auto)
+  operator() (KeyAndPayload const &keyAndPayload) const
+  {
+    return std::get<0> (keyAndPayload);
+  }
+};
+
+struct PayloadOfPair
+{
+  template <typename KeyAndPayload>
+  [[nodiscard]] decltype (auto)
+  operator() (KeyAndPayload const &keyAndPayload) const
+  {
+    return std::get<1> (keyAndPayload);
+  }
+};
+}
+
+/*
+SmallMemoryTree for payloads which get looked up by a key. Keys and payloads get stored in two columns, every node stores its key and its payload once.
+getValues () returns the key column so every lookup function (calcChildrenIndexForPath, calcChildrenIndexForPaths, Cursor, EytzingerIndex, ...) takes paths of keys and compares only keys.
+A search over the children reads sizeof (KeyType) bytes per child. The payloads get read only for the node which was found, see calcPayloadForPath and calcChildrenPayloadSpanForPath.
+Tree adapters, breadth first sources and SmallMemoryTrees get split into the two columns with keyProjection and payloadProjection. They get called with std::invoke so member pointers work, for example
+KeyedSmallMemoryTree<uint32_t, std::array<char, 60> >{ treeOfRecords, &Record::id, &Record::data }. The default projections take the key and the payload of a pair like node (key, payload) with std::get.
+*/
+template <typename KeyType, typename PayloadType, typename ChildrenOffsetEndType = uint64_t> class KeyedSmallMemoryTree
+{
+public:
+  KeyedSmallMemoryTree () = default;
+
+  template <internals::HasIteratorToNode TreeAdapter, typename KeyProjection = internals::KeyOfPair, typename PayloadProjection = internals::PayloadOfPair> KeyedSmallMemoryTree (TreeAdapter const &treeAdapter, KeyProjection const &keyProjection = {}, PayloadProjection const &payloadProjection = {})
+  {
+    auto childrenSum = uint64_t{};
+    std::for_each (treeAdapter.constant_breadth_first_traversal_begin (), treeAdapter.constant_breadth_first_traversal_end (), [&] (auto const &node) mutable {
+      pushBackNode (node.data (), keyProjection, payloadProjection);
+      childrenSum += boost::numeric_cast<uint64_t> (std::distance (node.begin (), node.end ()));
+      childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
+    });
+    shrinkToFit ();
+  }
+
+  template <internals::IsBreadthFirstSource BreadthFirstSource, typename KeyProjection = internals::KeyOfPair, typename PayloadProjection = internals::PayloadOfPair> KeyedSmallMemoryTree (BreadthFirstSource const &breadthFirstSource, KeyProjection const &keyProjection = {}, PayloadProjection const &payloadProjection = {})
+  {
+    if constexpr (requires { breadthFirstSource.nodeCount (); })
+      {
+        keys.reserve (boost::numeric_cast<size_t> (breadthFirstSource.nodeCount ()));
+        payloads.reserve (boost::numeric_cast<size_t> (breadthFirstSource.nodeCount ()));
+        childrenOffsetEnds.reserve (boost::numeric_cast<size_t> (breadthFirstSource.nodeCount ()));
+      }
+    auto childrenSum = uint64_t{};
+    breadthFirstSource.visitBreadthFirst ([&] (auto const &value, uint64_t childrenCount) {
+      pushBackNode (value, keyProjection, payloadProjection);
+      childrenSum += childrenCount;
+      childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
+    });
+    shrinkToFit ();
+  }
+
+  // Throws std::logic_error if keys, payloads and childrenOffsetEnds do not have the same size
+  KeyedSmallMemoryTree (std::vector<KeyType> keys_, std::vector<PayloadType> payloads_, std::vector<ChildrenOffsetEndType> childrenOffsetEnds_) : keys{ std::move (keys_) }, payloads{ std::move (payloads_) }, childrenOffsetEnds{ std::move (childrenOffsetEnds_) }
+  {
+    if (keys.size () != payloads.size () or keys.size () != childrenOffsetEnds.size ()) throw std::logic_error{ "keys, payloads and childrenOffsetEnds need the same size" };
+  }
+
+  // Splits the values of smallMemoryTree into the two columns
+  template <typename ValueType, typename Allocator, typename KeyProjection = internals::KeyOfPair, typename PayloadProjection = internals::PayloadOfPair>
+  explicit KeyedSmallMemoryTree (SmallMemoryTree<ValueType, ChildrenOffsetEndType, Allocator> const &smallMemoryTree, KeyProjection const &keyProjection = {}, PayloadProjection const &payloadProjection = {}) : childrenOffsetEnds (smallMemoryTree.getChildrenOffsetEnds ().begin (), smallMemoryTree.getChildrenOffsetEnds ().end ())
+  {
+    keys.reserve (smallMemoryTree.getValues ().size ());
+    payloads.reserve (smallMemoryTree.getValues ().size ());
+    for (auto const &value : smallMemoryTree.getValues ())
+      {
+        pushBackNode (value, keyProjection, payloadProjection);
+      }
+  }
+
+  [[nodiscard]] bool operator== (KeyedSmallMemoryTree const &) const = default;
+
+  // The key column. Named getValues so KeyedSmallMemoryTree is a SmallMemoryTree of keys for the lookup functions
+  [[nodiscard]] std::vector<KeyType> const &
+  getValues () const
+  {
+    return keys;
+  }
+
+  // The payload of the node with index i is getPayloads ()[i]
+  [[nodiscard]] std::vector<PayloadType> const &
+  getPayloads () const
+  {
+    return payloads;
+  }
+
+  [[nodiscard]] std::vector<ChildrenOffsetEndType> const &
+  getChildrenOffsetEnds () const
+  {
+    return childrenOffsetEnds;
+  }
+
+private:
+  template <typename Node, typename KeyProjection, typename PayloadProjection>
+  void
+  pushBackNode (Node const &node, KeyProjection const &keyProjection, PayloadProjection const &payloadProjection)
+  {
+    keys.push_back (std::invoke (keyProjection, node));
+    payloads.push_back (std::invoke (payloadProjection, node));
+  }
+
+  void
+  shrinkToFit ()
+  {
+    keys.shrink_to_fit ();
+    payloads.shrink_to_fit ();
+    childrenOffsetEnds.shrink_to_fit ();
+  }
+
+  std::vector<KeyType> keys{};
+  std::vector<PayloadType> payloads{};
+  std::vector<ChildrenOffsetEndType> childrenOffsetEnds{};
+};
+
+namespace internals
+{
+template <typename T> concept IsKeyedSmallMemoryTree = IsSmallMemoryTree<T> and requires (T const a)
+{
+  {
+    a.getPayloads ()
+  } -> std::ranges::contiguous_range;
+};
+
+template <IsKeyedSmallMemoryTree KeyedSmallMemoryTreeType> using PayloadTypeOf = std::remove_cvref_t<std::ranges::range_value_t<decltype (std::declval<KeyedSmallMemoryTreeType const &> ().getPayloads ())> >;
+}
+
+// Returns a copy of the payload of the node path points to. path is a path of keys. Only the key column gets searched.
+template <internals::IsKeyedSmallMemoryTree KeyedSmallMemoryTreeType, std::ranges::input_range Path, internals::IsChildSearchFor<KeyedSmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<internals::PayloadTypeOf<KeyedSmallMemoryTreeType>, std::error_condition>
+calcPayloadForPath (KeyedSmallMemoryTreeType const &keyedSmallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  if (auto const &nodeIndexExpected = internals::nodeIndexForPath (keyedSmallMemoryTree, path, childSearch))
+    {
+      return std::span{ keyedSmallMemoryTree.getPayloads () }[nodeIndexExpected.value ()];
+    }
+  else
+    {
+      return std::unexpected (nodeIndexExpected.error ());
+    }
+}
+
+template <internals::IsKeyedSmallMemoryTree KeyedSmallMemoryTreeType, internals::IsChildSearchFor<KeyedSmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<internals::PayloadTypeOf<KeyedSmallMemoryTreeType>, std::error_condition>
+calcPayloadForPath (KeyedSmallMemoryTreeType const &keyedSmallMemoryTree, std::initializer_list<internals::ValueTypeOf<KeyedSmallMemoryTreeType> > path, ChildSearch const &childSearch = false)
+{
+  return calcPayloadForPath (keyedSmallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+
+// Same as calcChildrenSpanForPath but the span points into getPayloads (). The keys of the children are in calcChildrenSpanForPath. Does not allocate.
+template <internals::IsKeyedSmallMemoryTree KeyedSmallMemoryTreeType, std::ranges::input_range Path, internals::IsChildSearchFor<KeyedSmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<internals::PayloadTypeOf<KeyedSmallMemoryTreeType> const>, std::error_condition>
+calcChildrenPayloadSpanForPath (KeyedSmallMemoryTreeType const &keyedSmallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  if (auto const &childrenIndexExpected = calcChildrenIndexForPath (keyedSmallMemoryTree, path, childSearch))
+    {
+      auto const &[childrenBeginIndex, childrenEndIndex] = childrenIndexExpected.value ();
+      return std::span{ keyedSmallMemoryTree.getPayloads () }.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+    }
+  else
+    {
+      return std::unexpected (childrenIndexExpected.error ());
+    }
+}
+
+template <internals::IsKeyedSmallMemoryTree KeyedSmallMemoryTreeType, internals::IsChildSearchFor<KeyedSmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<internals::PayloadTypeOf<KeyedSmallMemoryTreeType> const>, std::error_condition>
+calcChildrenPayloadSpanForPath (KeyedSmallMemoryTreeType const &keyedSmallMemoryTree, std::initializer_list<internals::ValueTypeOf<KeyedSmallMemoryTreeType> > path, ChildSearch const &childSearch = false)
+{
+  return calcChildrenPayloadSpanForPath (keyedSmallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+}
@@ -0,0 +1,149 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace small_memory_tree
+{
+namespace internals
+{
+// Source for the parallel construction. Nodes are handles (for example pointers) which can be used from multiple threads at the same time.
+// children (node) returns a range with the handles of the children of node in order.
+template <typename T> concept IsLevelSource = requires (T const a)
+{
+  {
+    a.nodeCount ()
+  } -> std::convertible_to<uint64_t>;
+  { a.root () };
+  {
+    a.children (a.root ())
+  } -> std::ranges::forward_range;
+  { a.value (a.root ()) };
+};
+
+template <IsLevelSource LevelSource> using NodeHandleOf = std::remove_cvref_t<decltype (std::declval<LevelSource const &> ().root ())>;
+
+// Calls function (begin, end) for threadCount chunks of [0, count) in parallel. The first exception thrown by function gets rethrown
+template <typename Function>
+void
+parallelForChunks (uint64_t count, uint64_t threadCount, Function const &function)
+{
+  threadCount = std::clamp<uint64_t> (threadCount, 1, std::max<uint64_t> (count, 1));
+  if (threadCount == 1)
+    {
+      function (uint64_t{}, count);
+      return;
+    }
+  auto exceptions = std::vector<std::exception_ptr> (threadCount);
+  auto const &runChunk = [&] (uint64_t chunk) {
+    try
+      {
+        function (count * chunk / threadCount, count * (chunk + 1) / threadCount);
+      }
+    catch (...)
+      {
+        exceptions.at (chunk) = std::current_exception ();
+      }
+  };
+  {
+    auto threads = std::vector<std::jthread>{};
+    threads.reserve (threadCount - 1);
+    for (auto chunk = uint64_t{ 1 }; chunk < threadCount; ++chunk)
+      {
+        threads.emplace_back (runChunk, chunk);
+      }
+    runChunk (0);
+  }
+  for (auto const &exception : exceptions)
+    {
+      if (exception) std::rethrow_exception (exception);
+    }
+}
+
+// In place inclusive scan. The chunk sums get calculated in parallel, get scanned and then every chunk gets scanned in parallel starting from its offset
+inline void
+parallelInclusiveScan (std::span<uint64_t> values, uint64_t threadCount)
+{
+  auto const chunkCount = std::clamp<uint64_t> (threadCount, 1, std::max<uint64_t> (values.size (), 1)); // std::clamp returns a reference to its arguments
+  auto const &chunk = [&values, chunkCount] (uint64_t chunkIndex) { return values.subspan (values.size () * chunkIndex / chunkCount, values.size () * (chunkIndex + 1) / chunkCount - values.size () * chunkIndex / chunkCount); };
+  auto chunkOffsets = std::vector<uint64_t> (chunkCount + 1);
+  parallelForChunks (chunkCount, chunkCount, [&] (uint64_t chunkBegin, uint64_t chunkEnd) {
+    for (auto chunkIndex = chunkBegin; chunkIndex < chunkEnd; ++chunkIndex)
+      {
+        auto const &chunkValues = chunk (chunkIndex);
+        chunkOffsets.at (chunkIndex + 1) = std::reduce (chunkValues.begin (), chunkValues.end (), uint64_t{});
+      }
+  });
+  std::partial_sum (chunkOffsets.begin (), chunkOffsets.end (), chunkOffsets.begin ());
+  parallelForChunks (chunkCount, chunkCount, [&] (uint64_t chunkBegin, uint64_t chunkEnd) {
+    for (auto chunkIndex = chunkBegin; chunkIndex < chunkEnd; ++chunkIndex)
+      {
+        auto const &chunkValues = chunk (chunkIndex);
+        std::inclusive_scan (chunkValues.begin (), chunkValues.end (), chunkValues.begin (), std::plus<> (), chunkOffsets.at (chunkIndex));
+      }
+  });
+}
+}
+
+/*
+Builds the same SmallMemoryTree as the serial constructor using threadCount threads. Works level by level:
+the values and children counts of a level get collected in parallel, the children counts get turned into childrenOffsetEnds with a parallel inclusive scan
+and the children get scattered into the next level in parallel.
+Levels with less than minNodesForParallelLevel nodes are processed by the calling thread because starting threads costs more than they save.
+*/
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t, internals::IsLevelSource LevelSource>
+[[nodiscard]] SmallMemoryTree<ValueType, ChildrenOffsetEndType>
+generateSmallMemoryTreeParallel (LevelSource const &levelSource, uint64_t threadCount = std::thread::hardware_concurrency (), uint64_t minNodesForParallelLevel = 4096)
+{
+  auto const &nodeCount = boost::numeric_cast<size_t> (levelSource.nodeCount ());
+  if (nodeCount == 0) return {};
+  auto values = std::vector<ValueType> (nodeCount);
+  auto childrenOffsetEnds = std::vector<ChildrenOffsetEndType> (nodeCount);
+  auto level = std::vector<internals::NodeHandleOf<LevelSource> >{ levelSource.root () };
+  auto nextLevel = std::vector<internals::NodeHandleOf<LevelSource> >{};
+  auto childrenSums = std::vector<uint64_t>{};
+  auto levelBegin = uint64_t{};
+  while (not level.empty ())
+    {
+      if (levelBegin + level.size () > nodeCount) throw std::logic_error{ "nodeCount is smaller than the number of nodes in the tree" };
+      auto const &levelThreadCount = (level.size () < minNodesForParallelLevel) ? uint64_t{ 1 } : threadCount;
+      childrenSums.resize (level.size ());
+      internals::parallelForChunks (level.size (), levelThreadCount, [&] (uint64_t begin, uint64_t end) {
+        for (auto i = begin; i < end; ++i)
+          {
+            values[levelBegin + i] = levelSource.value (level[i]);
+            childrenSums[i] = boost::numeric_cast<uint64_t> (std::ranges::distance (levelSource.children (level[i])));
+          }
+      });
+      internals::parallelInclusiveScan (childrenSums, levelThreadCount);
+      // the children of this level start right after this level
+      auto const &nextLevelBegin = levelBegin + level.size ();
+      nextLevel.resize (childrenSums.back ());
+      internals::parallelForChunks (level.size (), levelThreadCount, [&] (uint64_t begin, uint64_t end) {
+        for (auto i = begin; i < end; ++i)
+          {
+            childrenOffsetEnds[levelBegin + i] = boost::numeric_cast<ChildrenOffsetEndType> (nextLevelBegin - 1 + childrenSums[i]);
+            std::ranges::copy (levelSource.children (level[i]), nextLevel.begin () + static_cast<std::ptrdiff_t> ((i == 0) ? 0 : childrenSums[i - 1]));
+          }
+      });
+      levelBegin = nextLevelBegin;
+      std::swap (level, nextLevel);
+    }
+  if (levelBegin != nodeCount) throw std::logic_error{ "nodeCount is bigger than the number of nodes in the tree" };
+  return SmallMemoryTree<ValueType, ChildrenOffsetEndType>{ std::move (values), std::move (childrenOffsetEnds) };
+}
+}
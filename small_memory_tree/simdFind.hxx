@@ -0,0 +1,275 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define SMALL_MEMORY_TREE_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SMALL_MEMORY_TREE_SIMD_X86 0
+#endif
+
+namespace small_memory_tree::internals
+{
+// Integral types with a size of 1, 2, 4 or 8 bytes can be compared with SIMD instructions because equal means same bits.
+template <typename T> concept IsSimdComparable = std::integral<T> and not std::same_as<T, bool> and (sizeof (T) == 1 or sizeof (T) == 2 or sizeof (T) == 4 or sizeof (T) == 8);
+
+enum class SimdLevel
+{
+  Scalar,
+  Sse2,
+  Avx2,
+  Avx512
+};
+
+namespace simd
+{
+template <typename T>
+[[nodiscard]] size_t
+findScalar (T const *data, size_t size, T value)
+{
+  return static_cast<size_t> (std::find (data, data + size, value) - data);
+}
+
+#if SMALL_MEMORY_TREE_SIMD_X86
+// SSE2 is part of x86-64 so no target attribute is needed
+template <typename T>
+[[nodiscard]] inline __m128i
+broadcastSse2 (T value)
+{
+  if constexpr (sizeof (T) == 1) return _mm_set1_epi8 (static_cast<char> (value));
+  else if constexpr (sizeof (T) == 2)
+    return _mm_set1_epi16 (static_cast<short> (value));
+  else if constexpr (sizeof (T) == 4)
+    return _mm_set1_epi32 (static_cast<int> (value));
+  else
+    return _mm_set1_epi64x (static_cast<long long> (value));
+}
+
+// all bits of an equal element are set
+template <typename T>
+[[nodiscard]] inline __m128i
+equalSse2 (T const *data, __m128i needle)
+{
+  auto const &chunk = _mm_loadu_si128 (reinterpret_cast<__m128i const *> (data));
+  if constexpr (sizeof (T) == 1) return _mm_cmpeq_epi8 (chunk, needle);
+  else if constexpr (sizeof (T) == 2)
+    return _mm_cmpeq_epi16 (chunk, needle);
+  else if constexpr (sizeof (T) == 4)
+    return _mm_cmpeq_epi32 (chunk, needle);
+  else
+    {
+      // SSE2 has no 64 bit compare. Both 32 bit halves have to be equal
+      auto const &equal32 = _mm_cmpeq_epi32 (chunk, needle);
+      return _mm_and_si128 (equal32, _mm_shuffle_epi32 (equal32, _MM_SHUFFLE (2, 3, 0, 1)));
+    }
+}
+
+// one bit per byte
+[[nodiscard]] inline uint32_t
+byteMaskSse2 (__m128i equal)
+{
+  return static_cast<uint32_t> (_mm_movemask_epi8 (equal));
+}
+
+// Checks four chunks per iteration and only looks at the single chunks if one of them matched. This keeps the branch predictor out of the loop.
+template <typename T>
+[[nodiscard]] size_t
+findSse2 (T const *data, size_t size, T value)
+{
+  constexpr auto elementsPerChunk = sizeof (__m128i) / sizeof (T);
+  auto const &needle = broadcastSse2 (value);
+  auto i = size_t{};
+  for (; i + 4 * elementsPerChunk <= size; i += 4 * elementsPerChunk)
+    {
+      auto const &equal0 = equalSse2 (data + i, needle);
+      auto const &equal1 = equalSse2 (data + i + elementsPerChunk, needle);
+      auto const &equal2 = equalSse2 (data + i + 2 * elementsPerChunk, needle);
+      auto const &equal3 = equalSse2 (data + i + 3 * elementsPerChunk, needle);
+      if (byteMaskSse2 (_mm_or_si128 (_mm_or_si128 (equal0, equal1), _mm_or_si128 (equal2, equal3))))
+        {
+          auto const &mask = uint64_t{ byteMaskSse2 (equal0) } | (uint64_t{ byteMaskSse2 (equal1) } << 16) | (uint64_t{ byteMaskSse2 (equal2) } << 32) | (uint64_t{ byteMaskSse2 (equal3) } << 48);
+          return i + static_cast<size_t> (std::countr_zero (mask)) / sizeof (T);
+        }
+    }
+  for (; i + elementsPerChunk <= size; i += elementsPerChunk)
+    {
+      if (auto const &mask = byteMaskSse2 (equalSse2 (data + i, needle))) return i + static_cast<size_t> (std::countr_zero (mask)) / sizeof (T);
+    }
+  return i + findScalar (data + i, size - i, value);
+}
+
+template <typename T>
+[[nodiscard]] __attribute__ ((target ("avx2"))) inline __m256i
+broadcastAvx2 (T value)
+{
+  if constexpr (sizeof (T) == 1) return _mm256_set1_epi8 (static_cast<char> (value));
+  else if constexpr (sizeof (T) == 2)
+    return _mm256_set1_epi16 (static_cast<short> (value));
+  else if constexpr (sizeof (T) == 4)
+    return _mm256_set1_epi32 (static_cast<int> (value));
+  else
+    return _mm256_set1_epi64x (static_cast<long long> (value));
+}
+
+template <typename T>
+[[nodiscard]] __attribute__ ((target ("avx2"))) inline __m256i
+equalAvx2 (T const *data, __m256i needle)
+{
+  auto const &chunk = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (data));
+  if constexpr (sizeof (T) == 1) return _mm256_cmpeq_epi8 (chunk, needle);
+  else if constexpr (sizeof (T) == 2)
+    return _mm256_cmpeq_epi16 (chunk, needle);
+  else if constexpr (sizeof (T) == 4)
+    return _mm256_cmpeq_epi32 (chunk, needle);
+  else
+    return _mm256_cmpeq_epi64 (chunk, needle);
+}
+
+[[nodiscard]] __attribute__ ((target ("avx2"))) inline uint32_t
+byteMaskAvx2 (__m256i equal)
+{
+  return static_cast<uint32_t> (_mm256_movemask_epi8 (equal));
+}
+
+template <typename T>
+[[nodiscard]] __attribute__ ((target ("avx2"))) size_t
+findAvx2 (T const *data, size_t size, T value)
+{
+  constexpr auto elementsPerChunk = sizeof (__m256i) / sizeof (T);
+  auto const &needle = broadcastAvx2 (value);
+  auto i = size_t{};
+  for (; i + 4 * elementsPerChunk <= size; i += 4 * elementsPerChunk)
+    {
+      auto const &equal0 = equalAvx2 (data + i, needle);
+      auto const &equal1 = equalAvx2 (data + i + elementsPerChunk, needle);
+      auto const &equal2 = equalAvx2 (data + i + 2 * elementsPerChunk, needle);
+      auto const &equal3 = equalAvx2 (data + i + 3 * elementsPerChunk, needle);
+      if (byteMaskAvx2 (_mm256_or_si256 (_mm256_or_si256 (equal0, equal1), _mm256_or_si256 (equal2, equal3))))
+        {
+          auto const &mask01 = uint64_t{ byteMaskAvx2 (equal0) } | (uint64_t{ byteMaskAvx2 (equal1) } << 32);
+          if (mask01) return i + static_cast<size_t> (std::countr_zero (mask01)) / sizeof (T);
+          auto const &mask23 = uint64_t{ byteMaskAvx2 (equal2) } | (uint64_t{ byteMaskAvx2 (equal3) } << 32);
+          return i + 2 * elementsPerChunk + static_cast<size_t> (std::countr_zero (mask23)) / sizeof (T);
+        }
+    }
+  for (; i + elementsPerChunk <= size; i += elementsPerChunk)
+    {
+      if (auto const &mask = byteMaskAvx2 (equalAvx2 (data + i, needle))) return i + static_cast<size_t> (std::countr_zero (mask)) / sizeof (T);
+    }
+  return i + findScalar (data + i, size - i, value);
+}
+
+// one bit per element. Elements outside of loadMask are not read
+template <typename T>
+[[nodiscard]] __attribute__ ((target ("avx512f,avx512bw"))) inline uint64_t
+equalMaskAvx512 (T const *data, T value, uint64_t loadMask)
+{
+  if constexpr (sizeof (T) == 1) return _mm512_mask_cmpeq_epi8_mask (loadMask, _mm512_maskz_loadu_epi8 (loadMask, data), _mm512_set1_epi8 (static_cast<char> (value)));
+  else if constexpr (sizeof (T) == 2)
+    return _mm512_mask_cmpeq_epi16_mask (static_cast<__mmask32> (loadMask), _mm512_maskz_loadu_epi16 (static_cast<__mmask32> (loadMask), data), _mm512_set1_epi16 (static_cast<short> (value)));
+  else if constexpr (sizeof (T) == 4)
+    return _mm512_mask_cmpeq_epi32_mask (static_cast<__mmask16> (loadMask), _mm512_maskz_loadu_epi32 (static_cast<__mmask16> (loadMask), data), _mm512_set1_epi32 (static_cast<int> (value)));
+  else
+    return _mm512_mask_cmpeq_epi64_mask (static_cast<__mmask8> (loadMask), _mm512_maskz_loadu_epi64 (static_cast<__mmask8> (loadMask), data), _mm512_set1_epi64 (static_cast<long long> (value)));
+}
+
+template <typename T>
+[[nodiscard]] __attribute__ ((target ("avx512f,avx512bw"))) size_t
+findAvx512 (T const *data, size_t size, T value)
+{
+  constexpr auto elementsPerChunk = size_t{ 64 } / sizeof (T);
+  constexpr auto fullLoadMask = ~uint64_t{};
+  auto i = size_t{};
+  for (; i + 4 * elementsPerChunk <= size; i += 4 * elementsPerChunk)
+    {
+      auto const &mask0 = equalMaskAvx512 (data + i, value, fullLoadMask);
+      auto const &mask1 = equalMaskAvx512 (data + i + elementsPerChunk, value, fullLoadMask);
+      auto const &mask2 = equalMaskAvx512 (data + i + 2 * elementsPerChunk, value, fullLoadMask);
+      auto const &mask3 = equalMaskAvx512 (data + i + 3 * elementsPerChunk, value, fullLoadMask);
+      if (mask0 | mask1 | mask2 | mask3)
+        {
+          if (mask0) return i + static_cast<size_t> (std::countr_zero (mask0));
+          if (mask1) return i + elementsPerChunk + static_cast<size_t> (std::countr_zero (mask1));
+          if (mask2) return i + 2 * elementsPerChunk + static_cast<size_t> (std::countr_zero (mask2));
+          return i + 3 * elementsPerChunk + static_cast<size_t> (std::countr_zero (mask3));
+        }
+    }
+  for (; i < size; i += elementsPerChunk)
+    {
+      auto const &elementsLeft = size - i;
+      auto const &loadMask = (elementsLeft >= 64) ? fullLoadMask : (uint64_t{ 1 } << elementsLeft) - 1; // masked load instead of a scalar loop for the last chunk
+      if (auto const &mask = equalMaskAvx512 (data + i, value, loadMask)) return i + static_cast<size_t> (std::countr_zero (mask));
+    }
+  return size;
+}
+#endif
+}
+
+// Highest instruction set the cpu supports. Gets detected once.
+[[nodiscard]] inline SimdLevel
+simdLevel ()
+{
+#if SMALL_MEMORY_TREE_SIMD_X86
+  static auto const level = [] {
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f") and __builtin_cpu_supports ("avx512bw")) return SimdLevel::Avx512;
+    else if (__builtin_cpu_supports ("avx2"))
+      return SimdLevel::Avx2;
+    else
+      return SimdLevel::Sse2;
+  }();
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+template <IsSimdComparable T>
+[[nodiscard]] size_t
+simdFind (T const *data, size_t size, T value, SimdLevel level)
+{
+  switch (level)
+    {
+#if SMALL_MEMORY_TREE_SIMD_X86
+    case SimdLevel::Avx512:
+      return simd::findAvx512 (data, size, value);
+    case SimdLevel::Avx2:
+      return simd::findAvx2 (data, size, value);
+    case SimdLevel::Sse2:
+      // emulating the 64 bit compare costs more than it saves compared to std::find
+      if constexpr (sizeof (T) == 8) return simd::findScalar (data, size, value);
+      else
+        return simd::findSse2 (data, size, value);
+#endif
+    default:
+      return simd::findScalar (data, size, value);
+    }
+}
+
+// Index of the first element equal to value or values.size () if there is none.
+// Uses the widest SIMD instructions the cpu supports for integral types and std::ranges::find for everything else.
+template <typename T, typename ValueToLookFor>
+[[nodiscard]] size_t
+findIndex (std::span<T const> values, ValueToLookFor const &value)
+{
+  if constexpr (IsSimdComparable<T> and std::same_as<T, ValueToLookFor>)
+    {
+      return simdFind (values.data (), values.size (), value, simdLevel ());
+    }
+  else
+    {
+      return static_cast<size_t> (std::ranges::find (values, value) - values.begin ());
+    }
+}
+}
@@ -6,12 +6,21 @@ Distributed under the Boost Software License, Version 1.0.
  */
 
 #include "small_memory_tree/apiError.hxx"
+#include "small_memory_tree/simdFind.hxx"
 #include <algorithm>
 #include <boost/numeric/conversion/cast.hpp>
 #include <confu_algorithm/binaryFind.hxx>
+#include <cstdint>
 #include <expected>
 #include <format>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 namespace small_memory_tree
 {
 
@@ -45,143 +54,361 @@ template <typename T> concept HasIteratorToNode = requires (T a)
   } -> IsNode;
 };
 
+// Visitor which gets passed to visitBreadthFirst. Only used to check IsBreadthFirstSource
+struct BreadthFirstVisitorArchetype
+{
+  template <typename ValueType>
+  void
+  operator() (ValueType const &, uint64_t) const
+  {
+  }
+};
+
+// Source for a single pass construction. visitBreadthFirst calls visitor (value, childrenCount) for every node in breadth first order.
+// Nothing gets materialized between the source tree and SmallMemoryTree. If the source also has nodeCount () the memory gets reserved up front.
+template <typename T> concept IsBreadthFirstSource = requires (T const a, BreadthFirstVisitorArchetype visitor)
+{
+  { a.visitBreadthFirst (visitor) };
+};
+
+// Everything which stores values and childrenOffsetEnds the way SmallMemoryTree does.
+// Used so the lookup functions work on SmallMemoryTree and on SmallMemoryTreeView.
+template <typename T> concept IsSmallMemoryTree = requires (T const a)
+{
+  {
+    a.getValues ()
+  } -> std::ranges::contiguous_range;
+  { a.getChildrenOffsetEnds ().size () };
+  { a.getChildrenOffsetEnds ()[0] };
+};
+
+template <IsSmallMemoryTree SmallMemoryTreeType> using ValueTypeOf = std::remove_cvref_t<std::ranges::range_value_t<decltype (std::declval<SmallMemoryTreeType const &> ().getValues ())> >;
+
+template <IsSmallMemoryTree SmallMemoryTreeType> using ChildrenOffsetEndTypeOf = std::remove_cvref_t<decltype (std::declval<SmallMemoryTreeType const &> ().getChildrenOffsetEnds ()[0])>;
+
 }
 
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t> class SmallMemoryTree
+// Allocator gets rebound to ValueType and ChildrenOffsetEndType. With std::pmr::polymorphic_allocator (see pmr::SmallMemoryTree) many trees can share one memory resource
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t, typename Allocator = std::allocator<ValueType> > class SmallMemoryTree
 {
+  using ValueAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ValueType>;
+  using ChildrenOffsetEndAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ChildrenOffsetEndType>;
+
 public:
+  using allocator_type = Allocator;
+
   SmallMemoryTree () = default;
-  template <internals::HasIteratorToNode TreeAdapter> SmallMemoryTree (TreeAdapter const &treeAdapter)
+  explicit SmallMemoryTree (Allocator const &allocator) : values{ ValueAllocator{ allocator } }, childrenOffsetEnds{ ChildrenOffsetEndAllocator{ allocator } } {}
+
+  template <internals::HasIteratorToNode TreeAdapter> SmallMemoryTree (TreeAdapter const &treeAdapter, Allocator const &allocator = Allocator{}) : SmallMemoryTree{ allocator }
   {
-    auto childrenSum = ChildrenOffsetEndType{};
+    auto childrenSum = uint64_t{};
     std::for_each (treeAdapter.constant_breadth_first_traversal_begin (), treeAdapter.constant_breadth_first_traversal_end (), [&] (auto const &node) mutable {
       values.push_back (node.data ());
-      childrenSum += boost::numeric_cast<ChildrenOffsetEndType> (std::distance (node.begin (), node.end ()));
-      childrenOffsetEnds.push_back (childrenSum);
+      childrenSum += boost::numeric_cast<uint64_t> (std::distance (node.begin (), node.end ()));
+      childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
+    });
+    values.shrink_to_fit ();
+    childrenOffsetEnds.shrink_to_fit ();
+  }
+
+  template <internals::IsBreadthFirstSource BreadthFirstSource> SmallMemoryTree (BreadthFirstSource const &breadthFirstSource, Allocator const &allocator = Allocator{}) : SmallMemoryTree{ allocator }
+  {
+    if constexpr (requires { breadthFirstSource.nodeCount (); })
+      {
+        values.reserve (boost::numeric_cast<size_t> (breadthFirstSource.nodeCount ()));
+        childrenOffsetEnds.reserve (boost::numeric_cast<size_t> (breadthFirstSource.nodeCount ()));
+      }
+    auto childrenSum = uint64_t{};
+    breadthFirstSource.visitBreadthFirst ([&] (auto const &value, uint64_t childrenCount) {
+      values.push_back (value);
+      childrenSum += childrenCount;
+      childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
     });
     values.shrink_to_fit ();
     childrenOffsetEnds.shrink_to_fit ();
   }
 
-  SmallMemoryTree (std::vector<ValueType> values_, std::vector<ChildrenOffsetEndType> childrenOffsetEnds_) : values{ std::move (values_) }, childrenOffsetEnds{ std::move (childrenOffsetEnds_) } {}
+  SmallMemoryTree (std::vector<ValueType, ValueAllocator> values_, std::vector<ChildrenOffsetEndType, ChildrenOffsetEndAllocator> childrenOffsetEnds_) : values{ std::move (values_) }, childrenOffsetEnds{ std::move (childrenOffsetEnds_) } {}
 
   // clang-format off
     [[nodiscard]]
   auto operator<=> (const SmallMemoryTree &) const = default;
   // clang-format on
 
-  [[nodiscard]] std::vector<ValueType> const &
+  [[nodiscard]] std::vector<ValueType, ValueAllocator> const &
+  getValues () const
+  {
+    return values;
+  }
+
+  [[nodiscard]] std::vector<ChildrenOffsetEndType, ChildrenOffsetEndAllocator> const &
+  getChildrenOffsetEnds () const
+  {
+    return childrenOffsetEnds;
+  }
+
+  [[nodiscard]] Allocator
+  get_allocator () const
+  {
+    return Allocator{ values.get_allocator () };
+  }
+
+private:
+  std::vector<ValueType, ValueAllocator> values{};
+  std::vector<ChildrenOffsetEndType, ChildrenOffsetEndAllocator> childrenOffsetEnds{};
+};
+
+namespace pmr
+{
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t> using SmallMemoryTree = small_memory_tree::SmallMemoryTree<ValueType, ChildrenOffsetEndType, std::pmr::polymorphic_allocator<ValueType> >;
+}
+
+// Non owning SmallMemoryTree. Can be used to query values and childrenOffsetEnds which are stored somewhere else for example in a memory mapped file.
+// The memory values and childrenOffsetEnds point to has to outlive the view.
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t> class SmallMemoryTreeView
+{
+public:
+  SmallMemoryTreeView () = default;
+
+  SmallMemoryTreeView (std::span<ValueType const> values_, std::span<ChildrenOffsetEndType const> childrenOffsetEnds_) : values{ values_ }, childrenOffsetEnds{ childrenOffsetEnds_ } {}
+
+  template <typename Allocator> SmallMemoryTreeView (SmallMemoryTree<ValueType, ChildrenOffsetEndType, Allocator> const &smallMemoryTree) : values{ smallMemoryTree.getValues () }, childrenOffsetEnds{ smallMemoryTree.getChildrenOffsetEnds () } {}
+
+  [[nodiscard]] std::span<ValueType const>
   getValues () const
   {
     return values;
   }
 
-  [[nodiscard]] std::vector<ChildrenOffsetEndType> const &
+  [[nodiscard]] std::span<ChildrenOffsetEndType const>
   getChildrenOffsetEnds () const
   {
     return childrenOffsetEnds;
   }
 
 private:
-  std::vector<ValueType> values{};
-  std::vector<ChildrenOffsetEndType> childrenOffsetEnds{};
+  std::span<ValueType const> values{};
+  std::span<ChildrenOffsetEndType const> childrenOffsetEnds{};
 };
 
 namespace internals
 {
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
-[[nodiscard]] std::expected<ChildrenOffsetEndType, std::error_condition>
-getChildrenCount (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMemoryTree, uint64_t index)
+template <IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<ChildrenOffsetEndTypeOf<SmallMemoryTreeType>, std::error_condition>
+getChildrenCount (SmallMemoryTreeType const &smallMemoryTree, uint64_t index)
 {
   auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
   if (index >= childrenOffsetEnds.size ()) return std::unexpected (make_error_condition (ApiError::OutOfRange));
-  return (index == 0) ? childrenOffsetEnds.at (index) : childrenOffsetEnds.at (index) - childrenOffsetEnds.at (index - 1);
+  return (index == 0) ? childrenOffsetEnds[index] : childrenOffsetEnds[index] - childrenOffsetEnds[index - 1];
 }
 
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
+template <IsSmallMemoryTree SmallMemoryTreeType>
 [[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
-childrenBeginAndEndIndex (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMemoryTree, uint64_t index)
+childrenBeginAndEndIndex (SmallMemoryTreeType const &smallMemoryTree, uint64_t index)
 {
   if (auto const &childrenCountExpected = getChildrenCount (smallMemoryTree, index))
     {
       auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
       auto const &childrenCount = boost::numeric_cast<uint64_t> (childrenCountExpected.value ());
-      auto const &childrenOffsetEnd = boost::numeric_cast<uint64_t> (childrenOffsetEnds.at (index)) + 1 /*end has to be one element after the last element*/;
+      auto const &childrenOffsetEnd = boost::numeric_cast<uint64_t> (childrenOffsetEnds[index]) + 1 /*end has to be one element after the last element*/;
       auto const &childrenBegin = childrenOffsetEnd - childrenCount;
-      return std::tuple<ChildrenOffsetEndType, ChildrenOffsetEndType>{ childrenBegin, childrenOffsetEnd };
+      // childrenOffsetEnds can come from an untrusted source (for example a file) so make sure we do not point outside of values
+      if (childrenBegin > childrenOffsetEnd or childrenOffsetEnd > std::ranges::size (smallMemoryTree.getValues ())) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+      return std::tuple<uint64_t, uint64_t>{ childrenBegin, childrenOffsetEnd };
     }
   else
     {
       return std::unexpected (childrenCountExpected.error ());
     }
 }
+
+// Returns the index of the parent of the node at index. Binary search for the first node whose children end after index.
+// Parents are always in front of their children so only [0, index) gets searched
+template <IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<uint64_t, std::error_condition>
+parentIndex (SmallMemoryTreeType const &smallMemoryTree, uint64_t index)
+{
+  auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+  if (index >= childrenOffsetEnds.size ()) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+  if (index == 0) return std::unexpected (make_error_condition (ApiError::RootHasNoParent));
+  auto first = uint64_t{};
+  auto count = index;
+  while (count != 0)
+    {
+      auto const &step = count / 2;
+      if (boost::numeric_cast<uint64_t> (childrenOffsetEnds[first + step]) < index)
+        {
+          first += step + 1;
+          count -= step + 1;
+        }
+      else
+        {
+          count = step;
+        }
+    }
+  // childrenOffsetEnds can come from an untrusted source so there might be no node which has index as child
+  if (first == index) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+  return first;
+}
+
+// How a child gets searched in the children of a node. Either bool sortedNodes (true means the children are sorted and binary find gets used)
+// or an object with a findChild function for example EytzingerIndex.
+template <typename ChildSearch, typename SmallMemoryTreeType> concept IsChildSearchFor = std::same_as<ChildSearch, bool> or requires (ChildSearch const childSearch, std::span<ValueTypeOf<SmallMemoryTreeType> const> values, ValueTypeOf<SmallMemoryTreeType> const value)
+{
+  {
+    childSearch.findChild (values, uint64_t{}, uint64_t{}, value)
+  } -> std::convertible_to<uint64_t>;
+};
+
+// Returns the index of the child with valueToLookFor or childrenEndIndex if there is none
+template <typename ChildSearch, typename ValueType, typename ValueToLookFor>
+[[nodiscard]] uint64_t
+findChild (ChildSearch const &childSearch, std::span<ValueType const> values, uint64_t childrenBeginIndex, uint64_t childrenEndIndex, ValueToLookFor const &valueToLookFor)
+{
+  if constexpr (std::same_as<ChildSearch, bool>)
+    {
+      auto const &children = values.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+      if (childSearch)
+        {
+          return childrenBeginIndex + static_cast<uint64_t> (std::distance (children.begin (), confu_algorithm::binaryFind (children.begin (), children.end (), valueToLookFor)));
+        }
+      else
+        {
+          return childrenBeginIndex + findIndex (children, valueToLookFor);
+        }
+    }
+  else
+    {
+      return childSearch.findChild (values, childrenBeginIndex, childrenEndIndex, valueToLookFor);
+    }
+}
+
+inline void
+prefetch ([[maybe_unused]] void const *address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch (address);
+#endif
+}
+
+// One step of a path lookup. Searches valueToLookFor in the children [childrenBeginIndex, childrenEndIndex) and returns the begin and end index of the children of the found child
+template <IsSmallMemoryTree SmallMemoryTreeType, typename ValueToLookFor, typename ChildSearch>
+[[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
+childrenIndexOfChild (SmallMemoryTreeType const &smallMemoryTree, uint64_t childrenBeginIndex, uint64_t childrenEndIndex, ValueToLookFor const &valueToLookFor, ChildSearch const &childSearch)
+{
+  if (childrenBeginIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathTooLong));
+  auto const &childIndex = findChild (childSearch, std::span{ smallMemoryTree.getValues () }, childrenBeginIndex, childrenEndIndex, valueToLookFor);
+  if (childIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+  return childrenBeginAndEndIndex (smallMemoryTree, childIndex);
+}
+
+// Returns the index in getValues () of the node path points to
+template <IsSmallMemoryTree SmallMemoryTreeType, std::ranges::input_range Path, typename ChildSearch = bool>
+[[nodiscard]] std::expected<uint64_t, std::error_condition>
+nodeIndexForPath (SmallMemoryTreeType const &smallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  auto nodeIndex = uint64_t{};
+  auto pathIsEmpty = true;
+  for (auto const &valueToLookFor : path)
+    {
+      if (pathIsEmpty)
+        {
+          // the root gets searched like every other level so child searches see the same calls as in calcChildrenIndexForPath
+          if (values.empty () or findChild (childSearch, values, 0, 1, valueToLookFor) != 0) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+          pathIsEmpty = false;
+          continue;
+        }
+      if (auto const &childrenBeginAndEndIndexExpected = childrenBeginAndEndIndex (smallMemoryTree, nodeIndex))
+        {
+          auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+          if (childrenBeginIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathTooLong));
+          nodeIndex = findChild (childSearch, values, childrenBeginIndex, childrenEndIndex, valueToLookFor);
+          if (nodeIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+        }
+      else
+        {
+          return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+        }
+    }
+  if (pathIsEmpty) return std::unexpected (make_error_condition (ApiError::EmptyPath));
+  return nodeIndex;
+}
 }
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
-[[nodiscard]] std::expected<std::vector<ValueType>, std::error_condition>
-calcChildrenForPath (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMemoryTree, std::vector<ValueType> const &path, bool sortedNodes = false)
+// Returns the begin and end index of the children of the node path points to. Index means position in getValues ().
+// path can be any input range (std::vector, std::span, std::array, ...). Does not allocate.
+// childSearch is bool sortedNodes or a child search like EytzingerIndex, see internals::IsChildSearchFor.
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, std::ranges::input_range Path, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
+calcChildrenIndexForPath (SmallMemoryTreeType const &smallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
 {
-  if (not path.empty ())
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  auto childrenBeginIndex = uint64_t{};
+  auto childrenEndIndex = uint64_t{ 1 }; // the root is the only node on the first level
+  auto pathIsEmpty = true;
+  for (auto const &valueToLookFor : path)
     {
-      auto const &values = smallMemoryTree.getValues ();
-      auto nodesToCheckBeginAndEndIndex = std::optional<std::tuple<int64_t, int64_t> >{ std::make_tuple (0, 1) };
-      for (auto i = uint64_t{}; i < path.size (); ++i)
+      if (pathIsEmpty)
         {
-          auto const &valueToLookFor = path.at (i);
-          if (nodesToCheckBeginAndEndIndex.has_value ())
-            {
-              auto const &childrenBegin = values.begin () + std::get<0> (nodesToCheckBeginAndEndIndex.value ());
-              auto const &childrenEnd = values.begin () + std::get<1> (nodesToCheckBeginAndEndIndex.value ());
-              auto const &children = std::span{ childrenBegin, childrenEnd };
-              auto nodeItr = children.begin ();
-              if (sortedNodes)
-                {
-                  nodeItr = confu_algorithm::binaryFind (children.begin (), children.end (), valueToLookFor);
-                }
-              else
-                {
-                  nodeItr = std::ranges::find (children, valueToLookFor);
-                }
-              if (nodeItr != children.end ())
-                {
-                  if (auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (smallMemoryTree, boost::numeric_cast<uint64_t> (std::get<0> (nodesToCheckBeginAndEndIndex.value ()) + std::distance (children.begin (), nodeItr))))
-                    {
-                      auto const &childrenCount = std::get<1> (childrenBeginAndEndIndexExpected.value ()) - std::get<0> (childrenBeginAndEndIndexExpected.value ());
-                      if (childrenCount != 0)
-                        {
-                          nodesToCheckBeginAndEndIndex = childrenBeginAndEndIndexExpected.value ();
-                        }
-                      else
-                        {
-                          nodesToCheckBeginAndEndIndex = std::nullopt;
-                        }
-                    }
-                  else
-                    {
-                      return std::unexpected (childrenBeginAndEndIndexExpected.error ());
-                    }
-                }
-              else
-                {
-                  return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
-                }
-            }
-          else
-            {
-              return std::unexpected (make_error_condition (ApiError::PathTooLong));
-            }
+          if (values.empty ()) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+          pathIsEmpty = false;
         }
-      if (nodesToCheckBeginAndEndIndex.has_value ())
+      if (auto const &childrenBeginAndEndIndexExpected = internals::childrenIndexOfChild (smallMemoryTree, childrenBeginIndex, childrenEndIndex, valueToLookFor, childSearch))
         {
-          return std::vector<ValueType> (values.begin () + std::get<0> (nodesToCheckBeginAndEndIndex.value ()), values.begin () + std::get<1> (nodesToCheckBeginAndEndIndex.value ()));
+          std::tie (childrenBeginIndex, childrenEndIndex) = childrenBeginAndEndIndexExpected.value ();
         }
       else
         {
-          return std::vector<ValueType>{};
+          return std::unexpected (childrenBeginAndEndIndexExpected.error ());
         }
     }
+  if (pathIsEmpty) return std::unexpected (make_error_condition (ApiError::EmptyPath));
+  return std::tuple<uint64_t, uint64_t>{ childrenBeginIndex, childrenEndIndex };
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition>
+calcChildrenIndexForPath (SmallMemoryTreeType const &smallMemoryTree, std::initializer_list<internals::ValueTypeOf<SmallMemoryTreeType> > path, ChildSearch const &childSearch = false)
+{
+  return calcChildrenIndexForPath (smallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+
+// Same as calcChildrenForPath but returns a span into getValues () instead of copying the children. Does not allocate.
+// The span is valid as long as the values of smallMemoryTree are valid.
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, std::ranges::input_range Path, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<internals::ValueTypeOf<SmallMemoryTreeType> const>, std::error_condition>
+calcChildrenSpanForPath (SmallMemoryTreeType const &smallMemoryTree, Path const &path, ChildSearch const &childSearch = false)
+{
+  if (auto const &childrenIndexExpected = calcChildrenIndexForPath (smallMemoryTree, path, childSearch))
+    {
+      auto const &[childrenBeginIndex, childrenEndIndex] = childrenIndexExpected.value ();
+      return std::span{ smallMemoryTree.getValues () }.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+    }
+  else
+    {
+      return std::unexpected (childrenIndexExpected.error ());
+    }
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::span<internals::ValueTypeOf<SmallMemoryTreeType> const>, std::error_condition>
+calcChildrenSpanForPath (SmallMemoryTreeType const &smallMemoryTree, std::initializer_list<internals::ValueTypeOf<SmallMemoryTreeType> > path, ChildSearch const &childSearch = false)
+{
+  return calcChildrenSpanForPath (smallMemoryTree, std::span{ path.begin (), path.end () }, childSearch);
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::expected<std::vector<internals::ValueTypeOf<SmallMemoryTreeType> >, std::error_condition>
+calcChildrenForPath (SmallMemoryTreeType const &smallMemoryTree, std::vector<internals::ValueTypeOf<SmallMemoryTreeType> > const &path, ChildSearch const &childSearch = false)
+{
+  if (auto const &childrenExpected = calcChildrenSpanForPath (smallMemoryTree, path, childSearch))
+    {
+      return std::vector<internals::ValueTypeOf<SmallMemoryTreeType> > (childrenExpected->begin (), childrenExpected->end ());
+    }
   else
     {
-      return std::unexpected (make_error_condition (ApiError::EmptyPath));
+      return std::unexpected (childrenExpected.error ());
     }
 }
 }
\ No newline at end of file
@@ -0,0 +1,215 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <boost/numeric/conversion/cast.hpp>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace small_memory_tree
+{
+// Identifies a tree in a SmallMemoryTreeArena. Trees get numbered in the order they were added
+struct SmallMemoryTreeHandle
+{
+  uint32_t index{};
+
+  auto operator<=> (SmallMemoryTreeHandle const &) const = default;
+};
+
+/*
+Many small trees packed into one values buffer and one childrenOffsetEnds buffer. A tree is the range [treeBegins[i], treeBegins[i + 1]) of both buffers
+so every tree costs one element of treeBegins instead of two allocations and two vector headers. The childrenOffsetEnds of a tree are relative to the tree
+so getTree returns a SmallMemoryTreeView which works with every lookup function.
+Trees can only be added. Memory gets freed all at once by clear or the destructor.
+ChildrenOffsetEndType has to hold the node count of the biggest tree. Adding a tree which does not fit throws boost::numeric::bad_numeric_cast.
+*/
+template <typename ValueType, typename ChildrenOffsetEndType = uint16_t, typename Allocator = std::allocator<ValueType> > class SmallMemoryTreeArena
+{
+  using ValueAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ValueType>;
+  using ChildrenOffsetEndAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ChildrenOffsetEndType>;
+  using TreeBeginAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t>;
+
+public:
+  using allocator_type = Allocator;
+
+  SmallMemoryTreeArena () = default;
+  explicit SmallMemoryTreeArena (Allocator const &allocator) : values{ ValueAllocator{ allocator } }, childrenOffsetEnds{ ChildrenOffsetEndAllocator{ allocator } }, treeBegins (1, uint64_t{}, TreeBeginAllocator{ allocator }) {}
+
+  // Bulk construction. If the trees know their size the buffers get allocated only once
+  template <std::ranges::input_range Trees> explicit SmallMemoryTreeArena (Trees const &trees, Allocator const &allocator = Allocator{}) : SmallMemoryTreeArena{ allocator }
+  {
+    if constexpr (std::ranges::forward_range<Trees> and internals::IsSmallMemoryTree<std::ranges::range_value_t<Trees> >)
+      {
+        auto nodeCount = uint64_t{};
+        auto treeCount = uint64_t{};
+        for (auto const &tree : trees)
+          {
+            nodeCount += std::ranges::size (tree.getValues ());
+            ++treeCount;
+          }
+        reserve (treeCount, nodeCount);
+      }
+    for (auto const &tree : trees)
+      {
+        add (tree);
+      }
+  }
+
+  void
+  reserve (uint64_t treeCount, uint64_t nodeCount)
+  {
+    treeBegins.reserve (boost::numeric_cast<size_t> (treeCount + 1));
+    values.reserve (boost::numeric_cast<size_t> (nodeCount));
+    childrenOffsetEnds.reserve (boost::numeric_cast<size_t> (nodeCount));
+  }
+
+  // Copies smallMemoryTree into the arena
+  template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+  SmallMemoryTreeHandle
+  add (SmallMemoryTreeType const &smallMemoryTree)
+  {
+    return addTree ([&] () {
+      auto const &treeValues = smallMemoryTree.getValues ();
+      auto const &treeChildrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+      values.insert (values.end (), std::ranges::begin (treeValues), std::ranges::end (treeValues));
+      for (auto i = uint64_t{}; i < treeChildrenOffsetEnds.size (); ++i)
+        {
+          childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (treeChildrenOffsetEnds[i]));
+        }
+    });
+  }
+
+  template <internals::IsBreadthFirstSource BreadthFirstSource>
+  SmallMemoryTreeHandle
+  add (BreadthFirstSource const &breadthFirstSource)
+  {
+    return addTree ([&] () {
+      auto childrenSum = uint64_t{};
+      breadthFirstSource.visitBreadthFirst ([&] (auto const &value, uint64_t childrenCount) {
+        values.push_back (value);
+        childrenSum += childrenCount;
+        childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
+      });
+    });
+  }
+
+  template <internals::HasIteratorToNode TreeAdapter>
+  SmallMemoryTreeHandle
+  add (TreeAdapter const &treeAdapter)
+  {
+    return addTree ([&] () {
+      auto childrenSum = uint64_t{};
+      std::for_each (treeAdapter.constant_breadth_first_traversal_begin (), treeAdapter.constant_breadth_first_traversal_end (), [&] (auto const &node) mutable {
+        values.push_back (node.data ());
+        childrenSum += boost::numeric_cast<uint64_t> (std::distance (node.begin (), node.end ()));
+        childrenOffsetEnds.push_back (boost::numeric_cast<ChildrenOffsetEndType> (childrenSum));
+      });
+    });
+  }
+
+  // The view is valid until the next add or clear
+  [[nodiscard]] std::expected<SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>, std::error_condition>
+  getTree (SmallMemoryTreeHandle handle) const
+  {
+    if (handle.index >= size ()) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+    return treeAt (handle.index);
+  }
+
+  // Views of all trees in the order they were added. Scanning the trees this way walks both buffers from front to back
+  [[nodiscard]] auto
+  trees () const
+  {
+    return std::views::iota (uint64_t{}, size ()) | std::views::transform ([this] (uint64_t index) { return treeAt (index); });
+  }
+
+  [[nodiscard]] uint64_t
+  size () const
+  {
+    return treeBegins.size () - 1;
+  }
+
+  [[nodiscard]] bool
+  empty () const
+  {
+    return size () == 0;
+  }
+
+  [[nodiscard]] uint64_t
+  nodeCount () const
+  {
+    return values.size ();
+  }
+
+  // Removes all trees. Keeps the memory so the arena can be filled again without allocating
+  void
+  clear ()
+  {
+    values.clear ();
+    childrenOffsetEnds.clear ();
+    treeBegins.resize (1);
+  }
+
+  // Heap memory used by the arena in bytes
+  [[nodiscard]] uint64_t
+  memoryUsage () const
+  {
+    return values.capacity () * sizeof (ValueType) + childrenOffsetEnds.capacity () * sizeof (ChildrenOffsetEndType) + treeBegins.capacity () * sizeof (uint64_t);
+  }
+
+  [[nodiscard]] Allocator
+  get_allocator () const
+  {
+    return Allocator{ values.get_allocator () };
+  }
+
+private:
+  // appendNodes appends the nodes of one tree to values and childrenOffsetEnds. If it throws the nodes it appended get removed again
+  template <typename AppendNodes>
+  SmallMemoryTreeHandle
+  addTree (AppendNodes &&appendNodes)
+  {
+    auto const &handle = SmallMemoryTreeHandle{ boost::numeric_cast<uint32_t> (size ()) };
+    try
+      {
+        appendNodes ();
+        treeBegins.push_back (values.size ());
+      }
+    catch (...)
+      {
+        values.erase (values.begin () + static_cast<std::ptrdiff_t> (treeBegins.back ()), values.end ());
+        childrenOffsetEnds.erase (childrenOffsetEnds.begin () + static_cast<std::ptrdiff_t> (treeBegins.back ()), childrenOffsetEnds.end ());
+        throw;
+      }
+    return handle;
+  }
+
+  [[nodiscard]] SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>
+  treeAt (uint64_t index) const
+  {
+    auto const &treeBegin = treeBegins[index];
+    auto const &treeNodeCount = treeBegins[index + 1] - treeBegin;
+    return SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>{ std::span{ values }.subspan (treeBegin, treeNodeCount), std::span{ childrenOffsetEnds }.subspan (treeBegin, treeNodeCount) };
+  }
+
+  std::vector<ValueType, ValueAllocator> values{};
+  std::vector<ChildrenOffsetEndType, ChildrenOffsetEndAllocator> childrenOffsetEnds{};
+  std::vector<uint64_t, TreeBeginAllocator> treeBegins = std::vector<uint64_t, TreeBeginAllocator> (1); // treeBegins[i] is the index of the root of tree i. The last element is the end of the last tree
+};
+
+namespace pmr
+{
+template <typename ValueType, typename ChildrenOffsetEndType = uint16_t> using SmallMemoryTreeArena = small_memory_tree::SmallMemoryTreeArena<ValueType, ChildrenOffsetEndType, std::pmr::polymorphic_allocator<ValueType> >;
+}
+}
@@ -0,0 +1,155 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/parallelSmallMemoryTree.hxx"
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace small_memory_tree
+{
+namespace internals
+{
+// Range of paths with random access. Every path gets iterated more than once and the values of a path have to be sortable
+template <typename Paths> concept IsPathsRange = std::ranges::random_access_range<Paths> and std::ranges::sized_range<Paths> and std::ranges::forward_range<std::ranges::range_reference_t<Paths> > and std::totally_ordered<std::ranges::range_value_t<std::ranges::range_reference_t<Paths> > >;
+
+template <IsPathsRange Paths> using PathValueTypeOf = std::ranges::range_value_t<std::ranges::range_reference_t<Paths> >;
+
+// Looks up the paths [pathsBegin, pathsEnd) and writes the result of paths[i] into results[i].
+// Paths which share their first depth values form a group which shares the lookup result for these values. A group gets split by the value at depth
+// into smaller groups and the child for that value is looked up once per smaller group. Sorting the values of a group and not whole paths keeps the comparisons on contiguous memory.
+template <IsSmallMemoryTree SmallMemoryTreeType, IsPathsRange Paths, typename ChildSearch>
+void
+calcChildrenIndexForPathGroups (SmallMemoryTreeType const &smallMemoryTree, Paths const &paths, uint64_t pathsBegin, uint64_t pathsEnd, ChildSearch const &childSearch, std::span<std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition> > results)
+{
+  auto const &pathAt = [&paths] (uint64_t pathIndex) -> decltype (auto) { return std::ranges::begin (paths)[static_cast<std::ranges::range_difference_t<Paths> > (pathIndex)]; };
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  auto keyedPaths = std::vector<std::pair<PathValueTypeOf<Paths>, uint64_t> >{}; // value of the path at the depth of its group and the index of the path
+  keyedPaths.reserve (pathsEnd - pathsBegin);
+  for (auto pathIndex = pathsBegin; pathIndex < pathsEnd; ++pathIndex)
+    {
+      if (std::ranges::empty (pathAt (pathIndex))) results[pathIndex] = std::unexpected (make_error_condition (ApiError::EmptyPath));
+      else if (values.empty ())
+        results[pathIndex] = std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+      else
+        keyedPaths.emplace_back (PathValueTypeOf<Paths>{}, pathIndex);
+    }
+  struct Group
+  {
+    uint64_t begin{};
+    uint64_t end{};
+    uint64_t depth{};
+    std::tuple<uint64_t, uint64_t> childrenIndex{};
+  };
+  auto groups = std::vector<Group>{ Group{ 0, keyedPaths.size (), 0, { 0, 1 } } }; // the root is the only node on the first level
+  while (not groups.empty ())
+    {
+      auto const group = groups.back ();
+      groups.pop_back ();
+      auto const &[childrenBeginIndex, childrenEndIndex] = group.childrenIndex;
+      // the children get searched after the values of the group are sorted. A binary search starts in the middle
+      prefetch (values.data () + childrenBeginIndex);
+      prefetch (values.data () + childrenBeginIndex + (childrenEndIndex - childrenBeginIndex) / 2);
+      auto const &groupPaths = std::span{ keyedPaths }.subspan (group.begin, group.end - group.begin);
+      auto const &unfinishedPaths = std::ranges::partition (groupPaths, [&pathAt, depth = group.depth] (auto const &keyedPath) { return boost::numeric_cast<uint64_t> (std::ranges::distance (pathAt (keyedPath.second))) == depth; });
+      for (auto const &[value, pathIndex] : std::ranges::subrange{ groupPaths.begin (), unfinishedPaths.begin () })
+        {
+          results[pathIndex] = group.childrenIndex;
+        }
+      for (auto &[value, pathIndex] : unfinishedPaths)
+        {
+          auto const &path = pathAt (pathIndex);
+          value = *std::ranges::next (std::ranges::begin (path), static_cast<std::ranges::range_difference_t<decltype (path)> > (group.depth));
+        }
+      std::ranges::sort (unfinishedPaths, {}, [] (auto const &keyedPath) -> auto const & { return keyedPath.first; });
+      for (auto sameValueBegin = unfinishedPaths.begin (); sameValueBegin != unfinishedPaths.end ();)
+        {
+          auto const &sameValueEnd = std::ranges::find_if (sameValueBegin, unfinishedPaths.end (), [&sameValueBegin] (auto const &keyedPath) { return keyedPath.first != sameValueBegin->first; });
+          if (auto const &childrenIndexExpected = childrenIndexOfChild (smallMemoryTree, childrenBeginIndex, childrenEndIndex, sameValueBegin->first, childSearch))
+            {
+              groups.push_back (Group{ group.begin + static_cast<uint64_t> (sameValueBegin - groupPaths.begin ()), group.begin + static_cast<uint64_t> (sameValueEnd - groupPaths.begin ()), group.depth + 1, childrenIndexExpected.value () });
+            }
+          else
+            {
+              for (auto const &[value, pathIndex] : std::ranges::subrange{ sameValueBegin, sameValueEnd })
+                {
+                  results[pathIndex] = std::unexpected (childrenIndexExpected.error ());
+                }
+            }
+          sameValueBegin = sameValueEnd;
+        }
+    }
+}
+}
+
+/*
+Same as calling calcChildrenIndexForPath for every path in paths. Results are in the order of paths.
+Paths which start with the same values get grouped so the children for a shared prefix get looked up only once. Lookups for paths of the same group
+search the same children one after another so the tree stays in cache.
+With threadCount > 1 paths gets split into threadCount chunks which are looked up in parallel. Paths are grouped only inside a chunk.
+*/
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsPathsRange Paths, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::vector<std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition> >
+calcChildrenIndexForPaths (SmallMemoryTreeType const &smallMemoryTree, Paths const &paths, ChildSearch const &childSearch = false, uint64_t threadCount = 1)
+{
+  auto results = std::vector<std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition> > (boost::numeric_cast<size_t> (std::ranges::size (paths)));
+  internals::parallelForChunks (results.size (), threadCount, [&] (uint64_t begin, uint64_t end) { internals::calcChildrenIndexForPathGroups (smallMemoryTree, paths, begin, end, childSearch, std::span{ results }); });
+  return results;
+}
+
+// Same as calcChildrenIndexForPaths but returns spans into getValues (). The spans are valid as long as the values of smallMemoryTree are valid.
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsPathsRange Paths, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::vector<std::expected<std::span<internals::ValueTypeOf<SmallMemoryTreeType> const>, std::error_condition> >
+calcChildrenSpanForPaths (SmallMemoryTreeType const &smallMemoryTree, Paths const &paths, ChildSearch const &childSearch = false, uint64_t threadCount = 1)
+{
+  auto const &childrenIndexes = calcChildrenIndexForPaths (smallMemoryTree, paths, childSearch, threadCount);
+  auto results = std::vector<std::expected<std::span<internals::ValueTypeOf<SmallMemoryTreeType> const>, std::error_condition> >{};
+  results.reserve (childrenIndexes.size ());
+  for (auto const &childrenIndexExpected : childrenIndexes)
+    {
+      if (childrenIndexExpected)
+        {
+          auto const &[childrenBeginIndex, childrenEndIndex] = childrenIndexExpected.value ();
+          results.push_back (std::span{ smallMemoryTree.getValues () }.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex));
+        }
+      else
+        {
+          results.push_back (std::unexpected (childrenIndexExpected.error ()));
+        }
+    }
+  return results;
+}
+
+// Same as calcChildrenIndexForPaths but copies the children
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, internals::IsPathsRange Paths, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+[[nodiscard]] std::vector<std::expected<std::vector<internals::ValueTypeOf<SmallMemoryTreeType> >, std::error_condition> >
+calcChildrenForPaths (SmallMemoryTreeType const &smallMemoryTree, Paths const &paths, ChildSearch const &childSearch = false, uint64_t threadCount = 1)
+{
+  auto const &childrenSpans = calcChildrenSpanForPaths (smallMemoryTree, paths, childSearch, threadCount);
+  auto results = std::vector<std::expected<std::vector<internals::ValueTypeOf<SmallMemoryTreeType> >, std::error_condition> >{};
+  results.reserve (childrenSpans.size ());
+  for (auto const &childrenSpanExpected : childrenSpans)
+    {
+      if (childrenSpanExpected)
+        {
+          results.push_back (std::vector<internals::ValueTypeOf<SmallMemoryTreeType> > (childrenSpanExpected->begin (), childrenSpanExpected->end ()));
+        }
+      else
+        {
+          results.push_back (std::unexpected (childrenSpanExpected.error ()));
+        }
+    }
+  return results;
+}
+}
@@ -0,0 +1,268 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+namespace small_memory_tree
+{
+template <internals::IsSmallMemoryTree SmallMemoryTreeType> class Cursor;
+
+namespace internals
+{
+// Iterates the subtree of a node breadth first. The nodes of one level of a subtree are next to each other in getValues ()
+// so only the index range of the current level is stored. Iteration stops if childrenOffsetEnds is broken.
+template <IsSmallMemoryTree SmallMemoryTreeType> class BreadthFirstIterator
+{
+public:
+  using value_type = Cursor<SmallMemoryTreeType>;
+  using difference_type = std::ptrdiff_t;
+
+  BreadthFirstIterator () = default;
+
+  BreadthFirstIterator (SmallMemoryTreeType const &smallMemoryTree_, uint64_t index_) : smallMemoryTree{ &smallMemoryTree_ }, index{ index_ }, levelBegin{ index_ }, levelEnd{ index_ + 1 } {}
+
+  [[nodiscard]] value_type
+  operator* () const
+  {
+    return value_type{ *smallMemoryTree, index };
+  }
+
+  BreadthFirstIterator &
+  operator++ ()
+  {
+    if (++index == levelEnd)
+      {
+        auto const &firstNodeChildrenExpected = childrenBeginAndEndIndex (*smallMemoryTree, levelBegin);
+        auto const &lastNodeChildrenExpected = childrenBeginAndEndIndex (*smallMemoryTree, levelEnd - 1);
+        if (firstNodeChildrenExpected and lastNodeChildrenExpected and std::get<0> (firstNodeChildrenExpected.value ()) < std::get<1> (lastNodeChildrenExpected.value ()))
+          {
+            levelBegin = std::get<0> (firstNodeChildrenExpected.value ());
+            levelEnd = std::get<1> (lastNodeChildrenExpected.value ());
+            index = levelBegin;
+          }
+        else
+          {
+            levelBegin = levelEnd = index = 0;
+          }
+      }
+    return *this;
+  }
+
+  BreadthFirstIterator
+  operator++ (int)
+  {
+    auto result = *this;
+    ++*this;
+    return result;
+  }
+
+  [[nodiscard]] bool operator== (BreadthFirstIterator const &) const = default;
+
+  [[nodiscard]] bool
+  operator== (std::default_sentinel_t) const
+  {
+    return index == levelEnd;
+  }
+
+private:
+  SmallMemoryTreeType const *smallMemoryTree{};
+  uint64_t index{};
+  uint64_t levelBegin{};
+  uint64_t levelEnd{};
+};
+
+// Iterates the subtree of a node depth first (pre order). Does not need a stack because the parent of a node can be found with parentIndex.
+// Iteration stops if childrenOffsetEnds is broken.
+template <IsSmallMemoryTree SmallMemoryTreeType> class DepthFirstIterator
+{
+public:
+  using value_type = Cursor<SmallMemoryTreeType>;
+  using difference_type = std::ptrdiff_t;
+
+  DepthFirstIterator () = default;
+
+  DepthFirstIterator (SmallMemoryTreeType const &smallMemoryTree_, uint64_t index_) : smallMemoryTree{ &smallMemoryTree_ }, subtreeRoot{ index_ }, index{ index_ } {}
+
+  [[nodiscard]] value_type
+  operator* () const
+  {
+    return value_type{ *smallMemoryTree, index };
+  }
+
+  DepthFirstIterator &
+  operator++ ()
+  {
+    if (auto const &childrenExpected = childrenBeginAndEndIndex (*smallMemoryTree, index); childrenExpected and std::get<0> (childrenExpected.value ()) != std::get<1> (childrenExpected.value ()))
+      {
+        index = std::get<0> (childrenExpected.value ());
+        return *this;
+      }
+    // no children so continue with the next sibling of the node or of its nearest ancestor which has one
+    while (index != subtreeRoot)
+      {
+        auto const &parentIndexExpected = parentIndex (*smallMemoryTree, index);
+        if (not parentIndexExpected) break;
+        if (auto const &siblingsExpected = childrenBeginAndEndIndex (*smallMemoryTree, parentIndexExpected.value ()); siblingsExpected and index + 1 < std::get<1> (siblingsExpected.value ()))
+          {
+            ++index;
+            return *this;
+          }
+        index = parentIndexExpected.value ();
+      }
+    done = true;
+    return *this;
+  }
+
+  DepthFirstIterator
+  operator++ (int)
+  {
+    auto result = *this;
+    ++*this;
+    return result;
+  }
+
+  [[nodiscard]] bool operator== (DepthFirstIterator const &) const = default;
+
+  [[nodiscard]] bool
+  operator== (std::default_sentinel_t) const
+  {
+    return done;
+  }
+
+private:
+  SmallMemoryTreeType const *smallMemoryTree{};
+  uint64_t subtreeRoot{};
+  uint64_t index{};
+  bool done{};
+};
+}
+
+/*
+Points to a node of a SmallMemoryTree (or SmallMemoryTreeView ...). Lookups start at the node instead of the root so walking down a tree
+one level at a time costs one child search per level. A Cursor is an index plus a pointer to the tree, it does not allocate and the tree has to outlive it.
+*/
+template <internals::IsSmallMemoryTree SmallMemoryTreeType> class Cursor
+{
+public:
+  Cursor () = default;
+
+  // index 0 is the root
+  explicit Cursor (SmallMemoryTreeType const &smallMemoryTree_, uint64_t index_ = 0) : smallMemoryTree{ &smallMemoryTree_ }, index{ index_ } {}
+
+  [[nodiscard]] uint64_t
+  getIndex () const
+  {
+    return index;
+  }
+
+  [[nodiscard]] internals::ValueTypeOf<SmallMemoryTreeType> const &
+  getValue () const
+  {
+    return std::span{ smallMemoryTree->getValues () }[index];
+  }
+
+  [[nodiscard]] bool
+  isRoot () const
+  {
+    return index == 0;
+  }
+
+  [[nodiscard]] std::expected<std::span<internals::ValueTypeOf<SmallMemoryTreeType> const>, std::error_condition>
+  children () const
+  {
+    if (auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (*smallMemoryTree, index))
+      {
+        auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+        return std::span{ smallMemoryTree->getValues () }.subspan (childrenBeginIndex, childrenEndIndex - childrenBeginIndex);
+      }
+    else
+      {
+        return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+      }
+  }
+
+  // Cursors to the children of the node as a lazy range
+  [[nodiscard]] auto
+  childCursors () const
+  {
+    auto const &[childrenBeginIndex, childrenEndIndex] = internals::childrenBeginAndEndIndex (*smallMemoryTree, index).value_or (std::tuple<uint64_t, uint64_t>{});
+    return std::views::iota (childrenBeginIndex, childrenEndIndex) | std::views::transform ([smallMemoryTree_ = smallMemoryTree] (uint64_t childIndex) { return Cursor{ *smallMemoryTree_, childIndex }; });
+  }
+
+  // childSearch is bool sortedNodes or a child search like EytzingerIndex, see internals::IsChildSearchFor
+  template <internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+  [[nodiscard]] std::expected<Cursor, std::error_condition>
+  child (internals::ValueTypeOf<SmallMemoryTreeType> const &value, ChildSearch const &childSearch = false) const
+  {
+    if (auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (*smallMemoryTree, index))
+      {
+        auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+        if (childrenBeginIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathTooLong));
+        auto const &childIndex = internals::findChild (childSearch, std::span{ smallMemoryTree->getValues () }, childrenBeginIndex, childrenEndIndex, value);
+        if (childIndex == childrenEndIndex) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+        return Cursor{ *smallMemoryTree, childIndex };
+      }
+    else
+      {
+        return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+      }
+  }
+
+  // Follows path starting at the children of this node. Same as calling child for every value of path
+  template <std::ranges::input_range Path, internals::IsChildSearchFor<SmallMemoryTreeType> ChildSearch = bool>
+  [[nodiscard]] std::expected<Cursor, std::error_condition>
+  descendant (Path const &path, ChildSearch const &childSearch = false) const
+  {
+    auto result = std::expected<Cursor, std::error_condition>{ *this };
+    for (auto const &value : path)
+      {
+        result = result->child (value, childSearch);
+        if (not result) break;
+      }
+    return result;
+  }
+
+  [[nodiscard]] std::expected<Cursor, std::error_condition>
+  parent () const
+  {
+    if (auto const &parentIndexExpected = internals::parentIndex (*smallMemoryTree, index))
+      {
+        return Cursor{ *smallMemoryTree, parentIndexExpected.value () };
+      }
+    else
+      {
+        return std::unexpected (parentIndexExpected.error ());
+      }
+  }
+
+  // The node and all its descendants breadth first as a lazy range
+  [[nodiscard]] auto
+  breadthFirst () const
+  {
+    return std::ranges::subrange{ internals::BreadthFirstIterator<SmallMemoryTreeType>{ *smallMemoryTree, index }, std::default_sentinel };
+  }
+
+  // The node and all its descendants depth first (pre order) as a lazy range
+  [[nodiscard]] auto
+  depthFirst () const
+  {
+    return std::ranges::subrange{ internals::DepthFirstIterator<SmallMemoryTreeType>{ *smallMemoryTree, index }, std::default_sentinel };
+  }
+
+  [[nodiscard]] bool operator== (Cursor const &) const = default;
+
+private:
+  SmallMemoryTreeType const *smallMemoryTree{};
+  uint64_t index{};
+};
+}
@@ -0,0 +1,208 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <initializer_list>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace small_memory_tree
+{
+// Changes the value of the node path points to
+template <typename ValueType> struct ReplaceValue
+{
+  std::vector<ValueType> path{};
+  ValueType value{};
+};
+
+// Removes the node path points to and all its descendants. Removing the root results in an empty tree
+template <typename ValueType> struct RemoveSubtree
+{
+  std::vector<ValueType> path{};
+};
+
+// Inserts subtree as child of the node path points to. The root of subtree gets inserted in front of the child with index position counting the children of the unedited tree.
+// The default position appends subtree after the children. Inserting an empty subtree does nothing
+template <typename ValueType> struct InsertSubtree
+{
+  std::vector<ValueType> path{};
+  SmallMemoryTree<ValueType> subtree{};
+  uint64_t position{ std::numeric_limits<uint64_t>::max () };
+};
+
+template <typename ValueType> using Edit = std::variant<ReplaceValue<ValueType>, RemoveSubtree<ValueType>, InsertSubtree<ValueType> >;
+
+namespace internals
+{
+// Edits with their paths resolved to node indexes. Sorted by node index so applyEdits can merge them with the breadth first walk over the tree
+template <typename ValueType> struct ResolvedEdits
+{
+  std::vector<std::tuple<uint64_t, ValueType const *> > replacedValues{};                           // node index and new value
+  std::vector<uint64_t> removedNodes{};                                                            // node index
+  std::vector<std::tuple<uint64_t, uint64_t, SmallMemoryTree<ValueType> const *> > insertedSubtrees{}; // parent node index, position and subtree
+};
+
+template <IsSmallMemoryTree SmallMemoryTreeType, std::ranges::input_range Edits>
+[[nodiscard]] std::expected<ResolvedEdits<ValueTypeOf<SmallMemoryTreeType> >, std::error_condition>
+resolveEdits (SmallMemoryTreeType const &smallMemoryTree, Edits const &edits)
+{
+  using ValueType = ValueTypeOf<SmallMemoryTreeType>;
+  auto resolvedEdits = ResolvedEdits<ValueType>{};
+  for (auto const &edit : edits)
+    {
+      auto const &path = std::visit ([] (auto const &concreteEdit) { return std::span<ValueType const>{ concreteEdit.path }; }, edit);
+      auto const &nodeIndexExpected = nodeIndexForPath (smallMemoryTree, path);
+      if (not nodeIndexExpected) return std::unexpected (nodeIndexExpected.error ());
+      if (auto const *replaceValue = std::get_if<ReplaceValue<ValueType> > (&edit)) resolvedEdits.replacedValues.emplace_back (nodeIndexExpected.value (), &replaceValue->value);
+      else if (std::holds_alternative<RemoveSubtree<ValueType> > (edit))
+        resolvedEdits.removedNodes.push_back (nodeIndexExpected.value ());
+      else if (auto const &insertSubtree = std::get<InsertSubtree<ValueType> > (edit); not insertSubtree.subtree.getValues ().empty ())
+        resolvedEdits.insertedSubtrees.emplace_back (nodeIndexExpected.value (), insertSubtree.position, &insertSubtree.subtree);
+    }
+  std::ranges::sort (resolvedEdits.replacedValues, {}, [] (auto const &replacedValue) { return std::get<0> (replacedValue); });
+  std::ranges::sort (resolvedEdits.removedNodes);
+  // subtrees with the same parent and position keep the order of edits
+  std::ranges::stable_sort (resolvedEdits.insertedSubtrees, {}, [] (auto const &insertedSubtree) { return std::tuple{ std::get<0> (insertedSubtree), std::get<1> (insertedSubtree) }; });
+  auto const &sameNode = [] (auto const &lhs, auto const &rhs) { return std::get<0> (lhs) == std::get<0> (rhs); };
+  if (std::ranges::adjacent_find (resolvedEdits.replacedValues, sameNode) != resolvedEdits.replacedValues.end () or std::ranges::adjacent_find (resolvedEdits.removedNodes) != resolvedEdits.removedNodes.end ()) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+  return resolvedEdits;
+}
+}
+
+/*
+Applies edits to smallMemoryTree and returns the edited tree. smallMemoryTree does not change. All paths refer to the unedited tree so the order of edits does not matter
+except for subtrees inserted at the same position which get inserted in the order of edits.
+Returns ApiError::ConflictingEdits if a node gets replaced or removed twice or if an edit targets a node inside a removed subtree.
+Returns ApiError::OutOfRange if the edited tree does not fit into ChildrenOffsetEndType.
+The edited tree gets written level by level in one pass over the tree. The edits get merged into the pass because the nodes of the unedited tree are visited in the order of their index.
+If edits only replace values childrenOffsetEnds gets copied as is.
+*/
+template <internals::IsSmallMemoryTree SmallMemoryTreeType, std::ranges::input_range Edits>
+requires std::same_as<std::ranges::range_value_t<Edits>, Edit<internals::ValueTypeOf<SmallMemoryTreeType> > >
+[[nodiscard]] std::expected<SmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType>, internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType> >, std::error_condition>
+applyEdits (SmallMemoryTreeType const &smallMemoryTree, Edits const &edits)
+{
+  using ValueType = internals::ValueTypeOf<SmallMemoryTreeType>;
+  using ChildrenOffsetEndType = internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType>;
+  auto const &resolvedEditsExpected = internals::resolveEdits (smallMemoryTree, edits);
+  if (not resolvedEditsExpected) return std::unexpected (resolvedEditsExpected.error ());
+  auto const &[replacedValues, removedNodes, insertedSubtrees] = resolvedEditsExpected.value ();
+  auto const &inputValues = std::span{ smallMemoryTree.getValues () };
+  auto const &inputChildrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+  if (not removedNodes.empty () and removedNodes.front () == 0)
+    {
+      // every other edit targets a node inside the removed tree
+      if (replacedValues.size () + removedNodes.size () + insertedSubtrees.size () != 1) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+      return SmallMemoryTree<ValueType, ChildrenOffsetEndType>{};
+    }
+  auto values = std::vector<ValueType>{};
+  auto childrenOffsetEnds = std::vector<ChildrenOffsetEndType>{};
+  if (removedNodes.empty () and insertedSubtrees.empty ())
+    {
+      values.assign (inputValues.begin (), inputValues.end ());
+      childrenOffsetEnds.resize (inputChildrenOffsetEnds.size ());
+      for (auto i = uint64_t{}; i < inputChildrenOffsetEnds.size (); ++i)
+        {
+          childrenOffsetEnds[i] = inputChildrenOffsetEnds[i];
+        }
+      for (auto const &[nodeIndex, value] : replacedValues)
+        {
+          values[nodeIndex] = *value;
+        }
+      return SmallMemoryTree<ValueType, ChildrenOffsetEndType>{ std::move (values), std::move (childrenOffsetEnds) };
+    }
+  // node of the edited tree. index is an index into the unedited tree or into the subtree of insertedSubtrees[insertedSubtree]
+  struct NodeReference
+  {
+    uint64_t index{};
+    uint64_t insertedSubtree{ std::numeric_limits<uint64_t>::max () };
+  };
+  constexpr auto notInserted = std::numeric_limits<uint64_t>::max ();
+  auto level = std::vector<NodeReference>{ NodeReference{} };
+  auto nextLevel = std::vector<NodeReference>{};
+  auto replacedValue = replacedValues.begin ();
+  auto removedNode = removedNodes.begin ();
+  auto insertedSubtree = insertedSubtrees.begin ();
+  auto childrenSum = uint64_t{};
+  values.reserve (inputValues.size ());
+  childrenOffsetEnds.reserve (inputValues.size ());
+  while (not level.empty ())
+    {
+      nextLevel.clear ();
+      for (auto const &node : level)
+        {
+          auto const &nextLevelSizeBefore = nextLevel.size ();
+          if (node.insertedSubtree == notInserted)
+            {
+              // edits for a smaller index were skipped because their node is inside a removed subtree
+              if ((replacedValue != replacedValues.end () and std::get<0> (*replacedValue) < node.index) or (insertedSubtree != insertedSubtrees.end () and std::get<0> (*insertedSubtree) < node.index)) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+              if (replacedValue != replacedValues.end () and std::get<0> (*replacedValue) == node.index)
+                {
+                  values.push_back (*std::get<1> (*replacedValue));
+                  ++replacedValue;
+                }
+              else
+                {
+                  values.push_back (inputValues[node.index]);
+                }
+              auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (smallMemoryTree, node.index);
+              if (not childrenBeginAndEndIndexExpected) return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+              auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+              for (auto childIndex = childrenBeginIndex;; ++childIndex)
+                {
+                  for (; insertedSubtree != insertedSubtrees.end () and std::get<0> (*insertedSubtree) == node.index and (childIndex == childrenEndIndex or std::get<1> (*insertedSubtree) <= childIndex - childrenBeginIndex); ++insertedSubtree)
+                    {
+                      nextLevel.push_back (NodeReference{ 0, static_cast<uint64_t> (insertedSubtree - insertedSubtrees.begin ()) });
+                    }
+                  if (childIndex == childrenEndIndex) break;
+                  if (removedNode != removedNodes.end () and *removedNode < childIndex) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+                  if (removedNode != removedNodes.end () and *removedNode == childIndex) ++removedNode;
+                  else
+                    nextLevel.push_back (NodeReference{ childIndex, notInserted });
+                }
+            }
+          else
+            {
+              auto const &subtree = *std::get<2> (insertedSubtrees[node.insertedSubtree]);
+              values.push_back (subtree.getValues ()[node.index]);
+              auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (subtree, node.index);
+              if (not childrenBeginAndEndIndexExpected) return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+              auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+              for (auto childIndex = childrenBeginIndex; childIndex < childrenEndIndex; ++childIndex)
+                {
+                  nextLevel.push_back (NodeReference{ childIndex, node.insertedSubtree });
+                }
+            }
+          childrenSum += nextLevel.size () - nextLevelSizeBefore;
+          if (not std::in_range<ChildrenOffsetEndType> (childrenSum)) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+          childrenOffsetEnds.push_back (static_cast<ChildrenOffsetEndType> (childrenSum));
+        }
+      std::swap (level, nextLevel);
+    }
+  if (replacedValue != replacedValues.end () or removedNode != removedNodes.end () or insertedSubtree != insertedSubtrees.end ()) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+  values.shrink_to_fit ();
+  childrenOffsetEnds.shrink_to_fit ();
+  return SmallMemoryTree<ValueType, ChildrenOffsetEndType>{ std::move (values), std::move (childrenOffsetEnds) };
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<SmallMemoryTree<internals::ValueTypeOf<SmallMemoryTreeType>, internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType> >, std::error_condition>
+applyEdits (SmallMemoryTreeType const &smallMemoryTree, std::initializer_list<Edit<internals::ValueTypeOf<SmallMemoryTreeType> > > edits)
+{
+  return applyEdits (smallMemoryTree, std::span{ edits.begin (), edits.end () });
+}
+}
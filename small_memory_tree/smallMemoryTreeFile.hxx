@@ -0,0 +1,253 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <array>
+#include <bit>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <system_error>
+
+namespace small_memory_tree
+{
+/*
+Binary file format (version 1). All numbers are stored in the byte order of the machine which wrote the file.
+| offset                   | content                                                          |
+| 0                        | FileHeader (48 bytes)                                            |
+| valuesOffset             | nodeCount * sizeof (ValueType) values                            |
+| childrenOffsetEndsOffset | nodeCount * sizeof (ChildrenOffsetEndType) childrenOffsetEnds    |
+valuesOffset and childrenOffsetEndsOffset are aligned to fileSectionAlignment so the file can be memory mapped and used in place.
+*/
+namespace internals
+{
+inline constexpr auto fileMagic = std::array<char, 8>{ 'S', 'M', 'T', 'R', 'E', 'E', '\0', '\0' };
+inline constexpr uint16_t fileFormatVersion = 1;
+inline constexpr uint16_t fileByteOrderMark = 0xFEFF;
+inline constexpr uint64_t fileSectionAlignment = 64;
+
+enum class TypeTag : uint8_t
+{
+  Unknown = 0,
+  Bool,
+  Char,
+  Int8,
+  Uint8,
+  Int16,
+  Uint16,
+  Int32,
+  Uint32,
+  Int64,
+  Uint64,
+  Float,
+  Double
+};
+
+template <typename T>
+[[nodiscard]] constexpr TypeTag
+typeTag ()
+{
+  if constexpr (std::same_as<T, bool>) return TypeTag::Bool;
+  else if constexpr (std::same_as<T, char>)
+    return TypeTag::Char;
+  else if constexpr (std::signed_integral<T>)
+    {
+      if constexpr (sizeof (T) == 1) return TypeTag::Int8;
+      else if constexpr (sizeof (T) == 2)
+        return TypeTag::Int16;
+      else if constexpr (sizeof (T) == 4)
+        return TypeTag::Int32;
+      else if constexpr (sizeof (T) == 8)
+        return TypeTag::Int64;
+      else
+        return TypeTag::Unknown;
+    }
+  else if constexpr (std::unsigned_integral<T>)
+    {
+      if constexpr (sizeof (T) == 1) return TypeTag::Uint8;
+      else if constexpr (sizeof (T) == 2)
+        return TypeTag::Uint16;
+      else if constexpr (sizeof (T) == 4)
+        return TypeTag::Uint32;
+      else if constexpr (sizeof (T) == 8)
+        return TypeTag::Uint64;
+      else
+        return TypeTag::Unknown;
+    }
+  else if constexpr (std::same_as<T, float>)
+    return TypeTag::Float;
+  else if constexpr (std::same_as<T, double>)
+    return TypeTag::Double;
+  else
+    return TypeTag::Unknown; // for example a struct. Only the size of the type gets checked
+}
+
+struct FileHeader
+{
+  std::array<char, 8> magic{};
+  uint16_t version{};
+  uint16_t byteOrderMark{};
+  uint8_t valueTypeTag{};
+  uint8_t valueTypeSize{};
+  uint8_t childrenOffsetEndTypeTag{};
+  uint8_t childrenOffsetEndTypeSize{};
+  uint64_t nodeCount{};
+  uint64_t valuesOffset{};
+  uint64_t childrenOffsetEndsOffset{};
+  uint64_t fileSize{};
+};
+static_assert (sizeof (FileHeader) == 48);
+static_assert (std::is_trivially_copyable_v<FileHeader>);
+
+[[nodiscard]] constexpr uint64_t
+alignUp (uint64_t value, uint64_t alignment)
+{
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T> concept IsStorableInFile = std::is_trivially_copyable_v<T> and std::is_standard_layout_v<T> and sizeof (T) <= std::numeric_limits<uint8_t>::max ();
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+requires std::ranges::contiguous_range<decltype (std::declval<SmallMemoryTreeType const &> ().getChildrenOffsetEnds ())>
+[[nodiscard]] std::vector<std::byte>
+serialize (SmallMemoryTreeType const &smallMemoryTree)
+{
+  using ValueType = internals::ValueTypeOf<SmallMemoryTreeType>;
+  using ChildrenOffsetEndType = internals::ChildrenOffsetEndTypeOf<SmallMemoryTreeType>;
+  static_assert (internals::IsStorableInFile<ValueType>, "ValueType has to be trivially copyable to be saved in the binary format");
+  static_assert (internals::IsStorableInFile<ChildrenOffsetEndType>, "ChildrenOffsetEndType has to be trivially copyable to be saved in the binary format");
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  auto const &childrenOffsetEnds = std::span{ smallMemoryTree.getChildrenOffsetEnds () };
+  auto header = internals::FileHeader{};
+  header.magic = internals::fileMagic;
+  header.version = internals::fileFormatVersion;
+  header.byteOrderMark = internals::fileByteOrderMark;
+  header.valueTypeTag = static_cast<uint8_t> (internals::typeTag<ValueType> ());
+  header.valueTypeSize = sizeof (ValueType);
+  header.childrenOffsetEndTypeTag = static_cast<uint8_t> (internals::typeTag<ChildrenOffsetEndType> ());
+  header.childrenOffsetEndTypeSize = sizeof (ChildrenOffsetEndType);
+  header.nodeCount = values.size ();
+  header.valuesOffset = internals::alignUp (sizeof (internals::FileHeader), internals::fileSectionAlignment);
+  header.childrenOffsetEndsOffset = internals::alignUp (header.valuesOffset + values.size_bytes (), internals::fileSectionAlignment);
+  header.fileSize = header.childrenOffsetEndsOffset + childrenOffsetEnds.size_bytes ();
+  auto result = std::vector<std::byte> (header.fileSize);
+  std::memcpy (result.data (), &header, sizeof (header));
+  if (not values.empty ()) std::memcpy (result.data () + header.valuesOffset, values.data (), values.size_bytes ());
+  if (not childrenOffsetEnds.empty ()) std::memcpy (result.data () + header.childrenOffsetEndsOffset, childrenOffsetEnds.data (), childrenOffsetEnds.size_bytes ());
+  return result;
+}
+
+// Checks the header and returns a view into bytes. Nothing gets copied so bytes has to outlive the view.
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
+[[nodiscard]] std::expected<SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>, std::error_condition>
+viewFromBytes (std::span<std::byte const> bytes)
+{
+  static_assert (internals::IsStorableInFile<ValueType>, "ValueType has to be trivially copyable to be read from the binary format");
+  static_assert (internals::IsStorableInFile<ChildrenOffsetEndType>, "ChildrenOffsetEndType has to be trivially copyable to be read from the binary format");
+  if (bytes.size () < sizeof (internals::FileHeader)) return std::unexpected (make_error_condition (ApiError::InvalidFileFormat));
+  auto header = internals::FileHeader{};
+  std::memcpy (&header, bytes.data (), sizeof (header));
+  if (header.magic != internals::fileMagic) return std::unexpected (make_error_condition (ApiError::InvalidFileFormat));
+  if (header.byteOrderMark != internals::fileByteOrderMark)
+    {
+      return std::unexpected (make_error_condition ((header.byteOrderMark == std::byteswap (internals::fileByteOrderMark)) ? ApiError::ByteOrderMismatch : ApiError::InvalidFileFormat));
+    }
+  if (header.version != internals::fileFormatVersion) return std::unexpected (make_error_condition (ApiError::UnsupportedFileVersion));
+  if (header.valueTypeTag != static_cast<uint8_t> (internals::typeTag<ValueType> ()) or header.valueTypeSize != sizeof (ValueType) or header.childrenOffsetEndTypeTag != static_cast<uint8_t> (internals::typeTag<ChildrenOffsetEndType> ()) or header.childrenOffsetEndTypeSize != sizeof (ChildrenOffsetEndType))
+    {
+      return std::unexpected (make_error_condition (ApiError::TypeMismatch));
+    }
+  auto const &sectionFits = [&bytes, nodeCount = header.nodeCount] (uint64_t sectionOffset, uint64_t elementSize) {
+    if (nodeCount > std::numeric_limits<uint64_t>::max () / elementSize) return false;
+    return sectionOffset <= bytes.size () and nodeCount * elementSize <= bytes.size () - sectionOffset;
+  };
+  if (header.fileSize > bytes.size () or not sectionFits (header.valuesOffset, sizeof (ValueType)) or not sectionFits (header.childrenOffsetEndsOffset, sizeof (ChildrenOffsetEndType)))
+    {
+      return std::unexpected (make_error_condition (ApiError::InvalidFileFormat));
+    }
+  auto const *valuesBegin = bytes.data () + header.valuesOffset;
+  auto const *childrenOffsetEndsBegin = bytes.data () + header.childrenOffsetEndsOffset;
+  if (reinterpret_cast<std::uintptr_t> (valuesBegin) % alignof (ValueType) != 0 or reinterpret_cast<std::uintptr_t> (childrenOffsetEndsBegin) % alignof (ChildrenOffsetEndType) != 0)
+    {
+      return std::unexpected (make_error_condition (ApiError::Misaligned));
+    }
+  auto const &nodeCount = header.nodeCount;
+  auto result = SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>{ std::span{ reinterpret_cast<ValueType const *> (valuesBegin), nodeCount }, std::span{ reinterpret_cast<ChildrenOffsetEndType const *> (childrenOffsetEndsBegin), nodeCount } };
+  // every node except the root is a child of another node. This is a cheap sanity check, lookups check the ranges they use
+  if (nodeCount != 0 and static_cast<uint64_t> (result.getChildrenOffsetEnds ().back ()) != nodeCount - 1) return std::unexpected (make_error_condition (ApiError::InvalidFileFormat));
+  return result;
+}
+
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<void, std::error_condition>
+saveToFile (SmallMemoryTreeType const &smallMemoryTree, std::filesystem::path const &path)
+{
+  auto const &bytes = serialize (smallMemoryTree);
+  auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+  file.write (reinterpret_cast<char const *> (bytes.data ()), static_cast<std::streamsize> (bytes.size ()));
+  if (not file) return std::unexpected (std::make_error_condition (std::errc::io_error));
+  return {};
+}
+
+// Memory maps a file written with saveToFile. Cold start costs page faults instead of parsing and copying.
+template <typename ValueType, typename ChildrenOffsetEndType = uint64_t> class MappedSmallMemoryTree
+{
+public:
+  [[nodiscard]] static std::expected<MappedSmallMemoryTree, std::error_condition>
+  open (std::filesystem::path const &path)
+  {
+    try
+      {
+        auto const &fileMapping = boost::interprocess::file_mapping{ path.c_str (), boost::interprocess::read_only };
+        auto mappedRegion = boost::interprocess::mapped_region{ fileMapping, boost::interprocess::read_only };
+        if (auto viewExpected = viewFromBytes<ValueType, ChildrenOffsetEndType> (std::span{ static_cast<std::byte const *> (mappedRegion.get_address ()), mappedRegion.get_size () }))
+          {
+            return MappedSmallMemoryTree{ std::move (mappedRegion), viewExpected.value () };
+          }
+        else
+          {
+            return std::unexpected (viewExpected.error ());
+          }
+      }
+    catch (boost::interprocess::interprocess_exception const &exception)
+      {
+        return std::unexpected (std::system_category ().default_error_condition (exception.get_native_error ()));
+      }
+  }
+
+  [[nodiscard]] std::span<ValueType const>
+  getValues () const
+  {
+    return view.getValues ();
+  }
+
+  [[nodiscard]] std::span<ChildrenOffsetEndType const>
+  getChildrenOffsetEnds () const
+  {
+    return view.getChildrenOffsetEnds ();
+  }
+
+  [[nodiscard]] SmallMemoryTreeView<ValueType, ChildrenOffsetEndType>
+  getView () const
+  {
+    return view;
+  }
+
+private:
+  MappedSmallMemoryTree (boost::interprocess::mapped_region mappedRegion_, SmallMemoryTreeView<ValueType, ChildrenOffsetEndType> view_) : mappedRegion{ std::move (mappedRegion_) }, view{ view_ } {}
+
+  boost::interprocess::mapped_region mappedRegion{}; // moving a mapped_region does not change the address so view stays valid
+  SmallMemoryTreeView<ValueType, ChildrenOffsetEndType> view{};
+};
+}
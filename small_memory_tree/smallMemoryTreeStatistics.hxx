@@ -0,0 +1,207 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <boost/numeric/conversion/cast.hpp>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace small_memory_tree
+{
+// What one child search did. A path lookup does one child search per value of the path
+struct LevelStatistics
+{
+  uint64_t childrenCount{};
+  uint64_t comparisons{};
+  uint64_t bytesScanned{};
+};
+
+// Sums up the LevelStatistics of all lookups. A lookup starts with the search for the root so lookups counts the searches in [0, 1).
+// Not thread safe. Use one LookupStatistics per thread and add them up.
+struct LookupStatistics
+{
+  uint64_t lookups{};
+  uint64_t levels{};
+  uint64_t comparisons{};
+  uint64_t bytesScanned{};
+
+  void
+  recordLevel (uint64_t childrenBeginIndex, LevelStatistics const &levelStatistics)
+  {
+    if (childrenBeginIndex == 0) lookups++;
+    levels++;
+    comparisons += levelStatistics.comparisons;
+    bytesScanned += levelStatistics.bytesScanned;
+  }
+
+  LookupStatistics &
+  operator+= (LookupStatistics const &other)
+  {
+    lookups += other.lookups;
+    levels += other.levels;
+    comparisons += other.comparisons;
+    bytesScanned += other.bytesScanned;
+    return *this;
+  }
+
+  auto operator<=> (LookupStatistics const &) const = default;
+};
+
+// Recorder which does nothing. InstrumentedChildSearch<ChildSearch, NoLookupStatistics> compiles to the same code as ChildSearch
+struct NoLookupStatistics
+{
+  void
+  recordLevel (uint64_t, LevelStatistics const &) const
+  {
+  }
+};
+
+namespace internals
+{
+template <typename T> concept IsLookupRecorder = requires (T &recorder, uint64_t childrenBeginIndex, LevelStatistics const levelStatistics)
+{
+  { recorder.recordLevel (childrenBeginIndex, levelStatistics) };
+};
+}
+
+/*
+Child search (see internals::IsChildSearchFor) which searches with childSearch and passes what every search did to recorder.recordLevel (childrenBeginIndex, LevelStatistics).
+Instrumentation is opt in: lookups which get passed a plain child search are not changed. Recorder is the export hook. LookupStatistics sums up the counts,
+a custom Recorder can forward them to a metrics library. Recorder NoLookupStatistics removes the instrumentation at compile time.
+Comparisons are exact for a linear search (sortedNodes false). For binary find and other child searches they are the bit width of the children count which is the number of probes of a binary search.
+*/
+template <typename ChildSearch = bool, internals::IsLookupRecorder Recorder = LookupStatistics> class InstrumentedChildSearch
+{
+public:
+  explicit InstrumentedChildSearch (Recorder &recorder_, ChildSearch childSearch_ = ChildSearch{}) : recorder{ &recorder_ }, childSearch{ std::move (childSearch_) } {}
+
+  template <typename ValueType, typename ValueToLookFor>
+  [[nodiscard]] uint64_t
+  findChild (std::span<ValueType const> values, uint64_t childrenBeginIndex, uint64_t childrenEndIndex, ValueToLookFor const &valueToLookFor) const
+  {
+    auto const &childIndex = internals::findChild (childSearch, values, childrenBeginIndex, childrenEndIndex, valueToLookFor);
+    auto const &childrenCount = childrenEndIndex - childrenBeginIndex;
+    auto comparisons = boost::numeric_cast<uint64_t> (std::bit_width (childrenCount));
+    if constexpr (std::same_as<ChildSearch, bool>)
+      {
+        if (not childSearch) comparisons = (childIndex == childrenEndIndex) ? childrenCount : childIndex - childrenBeginIndex + 1;
+      }
+    recorder->recordLevel (childrenBeginIndex, LevelStatistics{ childrenCount, comparisons, comparisons * sizeof (ValueType) });
+    return childIndex;
+  }
+
+private:
+  Recorder *recorder{};
+  ChildSearch childSearch{};
+};
+
+// Shape and memory of a tree. Returned by analyze
+struct TreeAnalysis
+{
+  uint64_t nodeCount{};
+  uint64_t depth{};                         // number of levels
+  std::vector<uint64_t> nodeCountPerLevel{}; // nodeCountPerLevel[0] is 1 for the root
+  std::map<uint64_t, uint64_t> fanOutHistogram{}; // children count to number of nodes with that children count. Leaves have children count 0
+  uint64_t heapBytes{};                      // heap memory owned by the tree. 0 for views and FixedSmallMemoryTree
+  uint64_t valueBytes{};                     // nodeCount * sizeof (ValueType)
+  std::array<std::optional<uint64_t>, 4> childrenOffsetEndBytes{}; // bytes of childrenOffsetEnds with uint8_t, uint16_t, uint32_t and uint64_t. Empty if the biggest childrenOffsetEnd does not fit
+  bool childrenAreSorted{};                  // every node has sorted children so sortedNodes true can be used
+  double averageComparisonsLinearSearch{};   // comparisons to find a child, averaged over all children of all nodes
+  double averageComparisonsBinarySearch{};
+  double averageBytesScannedLinearSearch{};
+  double averageBytesScannedBinarySearch{};
+
+  [[nodiscard]] uint64_t
+  maxFanOut () const
+  {
+    return fanOutHistogram.empty () ? 0 : fanOutHistogram.rbegin ()->first;
+  }
+};
+
+namespace internals
+{
+// Heap bytes of a range returned by getValues or getChildrenOffsetEnds. Spans and std::array own no heap memory
+template <typename Range>
+[[nodiscard]] uint64_t
+heapBytes (Range const &range)
+{
+  if constexpr (requires { range.capacity (); }) return boost::numeric_cast<uint64_t> (range.capacity ()) * sizeof (std::ranges::range_value_t<Range>);
+  else
+    return 0;
+}
+}
+
+// Walks the tree once level by level. Returns the error of internals::childrenBeginAndEndIndex if childrenOffsetEnds points outside of values
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+[[nodiscard]] std::expected<TreeAnalysis, std::error_condition>
+analyze (SmallMemoryTreeType const &smallMemoryTree)
+{
+  using ValueType = internals::ValueTypeOf<SmallMemoryTreeType>;
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  auto const &childrenOffsetEnds = smallMemoryTree.getChildrenOffsetEnds ();
+  auto treeAnalysis = TreeAnalysis{};
+  treeAnalysis.nodeCount = values.size ();
+  if constexpr (requires { smallMemoryTree.memoryUsage (); }) treeAnalysis.heapBytes = boost::numeric_cast<uint64_t> (smallMemoryTree.memoryUsage ());
+  else
+    treeAnalysis.heapBytes = internals::heapBytes (smallMemoryTree.getValues ()) + internals::heapBytes (childrenOffsetEnds);
+  treeAnalysis.valueBytes = values.size () * sizeof (ValueType);
+  treeAnalysis.childrenAreSorted = std::totally_ordered<ValueType>;
+  auto maxChildrenOffsetEnd = uint64_t{};
+  auto comparisonsLinearSearch = uint64_t{};
+  auto comparisonsBinarySearch = uint64_t{};
+  auto levelBegin = uint64_t{};
+  auto levelEnd = std::min<uint64_t> (1, values.size ()); // the root is the only node on the first level
+  while (levelBegin != levelEnd)
+    {
+      treeAnalysis.nodeCountPerLevel.push_back (levelEnd - levelBegin);
+      auto nextLevelEnd = levelEnd;
+      for (auto nodeIndex = levelBegin; nodeIndex < levelEnd; ++nodeIndex)
+        {
+          auto const &childrenBeginAndEndIndexExpected = internals::childrenBeginAndEndIndex (smallMemoryTree, nodeIndex);
+          if (not childrenBeginAndEndIndexExpected) return std::unexpected (childrenBeginAndEndIndexExpected.error ());
+          auto const &[childrenBeginIndex, childrenEndIndex] = childrenBeginAndEndIndexExpected.value ();
+          auto const &childrenCount = childrenEndIndex - childrenBeginIndex;
+          treeAnalysis.fanOutHistogram[childrenCount]++;
+          maxChildrenOffsetEnd = std::max (maxChildrenOffsetEnd, boost::numeric_cast<uint64_t> (childrenOffsetEnds[nodeIndex]));
+          // finding the child at position i takes i + 1 comparisons. Summed up over all children
+          comparisonsLinearSearch += childrenCount * (childrenCount + 1) / 2;
+          comparisonsBinarySearch += childrenCount * boost::numeric_cast<uint64_t> (std::bit_width (childrenCount));
+          if constexpr (std::totally_ordered<ValueType>)
+            {
+              if (treeAnalysis.childrenAreSorted) treeAnalysis.childrenAreSorted = std::ranges::is_sorted (values.subspan (childrenBeginIndex, childrenCount));
+            }
+          nextLevelEnd = std::max (nextLevelEnd, childrenEndIndex);
+        }
+      levelBegin = levelEnd;
+      levelEnd = nextLevelEnd;
+    }
+  treeAnalysis.depth = treeAnalysis.nodeCountPerLevel.size ();
+  auto const &childrenOffsetEndBytes = [&treeAnalysis, maxChildrenOffsetEnd]<typename ChildrenOffsetEndType> (ChildrenOffsetEndType) -> std::optional<uint64_t> {
+    if (maxChildrenOffsetEnd > std::numeric_limits<ChildrenOffsetEndType>::max ()) return std::nullopt;
+    return treeAnalysis.nodeCount * sizeof (ChildrenOffsetEndType);
+  };
+  treeAnalysis.childrenOffsetEndBytes = { childrenOffsetEndBytes (uint8_t{}), childrenOffsetEndBytes (uint16_t{}), childrenOffsetEndBytes (uint32_t{}), childrenOffsetEndBytes (uint64_t{}) };
+  if (treeAnalysis.nodeCount > 1)
+    {
+      auto const &childCount = static_cast<double> (treeAnalysis.nodeCount - 1); // every node except the root is a child
+      treeAnalysis.averageComparisonsLinearSearch = static_cast<double> (comparisonsLinearSearch) / childCount;
+      treeAnalysis.averageComparisonsBinarySearch = static_cast<double> (comparisonsBinarySearch) / childCount;
+      treeAnalysis.averageBytesScannedLinearSearch = treeAnalysis.averageComparisonsLinearSearch * sizeof (ValueType);
+      treeAnalysis.averageBytesScannedBinarySearch = treeAnalysis.averageComparisonsBinarySearch * sizeof (ValueType);
+    }
+  return treeAnalysis;
+}
+}
@@ -7,10 +7,12 @@ Distributed under the Boost Software License, Version 1.0.
 
 #include "smallMemoryTree.hxx"
 #include "smallMemoryTreeAdapter.hxx"
+#include <ranges>
 #include <st_tree.h>
 namespace small_memory_tree
 {
 
+// Node adapter for BaseTreeAdapter. StTreeAdapter does not use it anymore. Kept for adapters which still derive from BaseTreeAdapter
 template <typename ValueType, typename NodeType> struct StTreeNodeAdapter : public BaseNodeAdapter<ValueType, NodeType>
 {
 
@@ -31,28 +33,65 @@ template <typename ValueType, typename NodeType> struct StTreeNodeAdapter : publ
   };
 };
 
-template <typename ValueType, typename NodeType = st_tree::detail::node_raw<st_tree::tree<ValueType>, ValueType>, typename TreeType = st_tree::tree<ValueType> > struct StTreeAdapter : public BaseTreeAdapter<StTreeNodeAdapter, ValueType, NodeType, TreeType>
+// Streams a st_tree::tree breadth first into SmallMemoryTree without copying its nodes. tree has to outlive the adapter.
+// Can also be passed to generateSmallMemoryTreeParallel. NodeType is not used. It is kept so code which names all template parameters still compiles
+template <typename ValueType, typename NodeType = st_tree::detail::node_raw<st_tree::tree<ValueType>, ValueType>, typename TreeType = st_tree::tree<ValueType> > class StTreeAdapter
 {
-  StTreeAdapter (st_tree::tree<ValueType> const &tree) : BaseTreeAdapter<StTreeNodeAdapter, ValueType, NodeType, TreeType>{ generateNodeAdapters (tree) } {}
+public:
+  StTreeAdapter (TreeType const &tree_) : tree{ &tree_ } {}
 
-  std::vector<StTreeNodeAdapter<ValueType, NodeType> >
-  generateNodeAdapters (TreeType const &tree)
+  [[nodiscard]] uint64_t
+  nodeCount () const
   {
-    auto results = std::vector<StTreeNodeAdapter<ValueType, NodeType> >{};
-    for (auto const &node : tree)
+    return boost::numeric_cast<uint64_t> (tree->size ());
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    // st_tree iterates breadth first by default
+    for (auto const &node : *tree)
       {
-        results.push_back (StTreeNodeAdapter<ValueType, NodeType>{ node });
+        visitor (node.data (), boost::numeric_cast<uint64_t> (node.size ()));
       }
-    return results;
   }
+
+  // functions for generateSmallMemoryTreeParallel. Nodes are pointers to st_tree nodes
+  [[nodiscard]] auto
+  root () const
+  {
+    return &tree->root ();
+  }
+
+  template <typename Node>
+  [[nodiscard]] static auto
+  children (Node const *node)
+  {
+    return *node | std::views::transform ([] (Node const &child) { return &child; });
+  }
+
+  template <typename Node>
+  [[nodiscard]] static ValueType const &
+  value (Node const *node)
+  {
+    return node->data ();
+  }
+
+private:
+  TreeType const *tree{};
 };
 
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
-inline std::expected<st_tree::tree<ValueType>, std::error_condition>
-generateStTree (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMemoryTree)
+template <typename ValueType> StTreeAdapter (st_tree::tree<ValueType> const &) -> StTreeAdapter<ValueType>;
+
+// Returns ApiError::OutOfRange for an empty tree because it has no root
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+inline std::expected<st_tree::tree<internals::ValueTypeOf<SmallMemoryTreeType> >, std::error_condition>
+generateStTree (SmallMemoryTreeType const &smallMemoryTree)
 {
-  auto const &values = smallMemoryTree.getValues ();
-  auto result = st_tree::tree<ValueType>{};
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  if (values.empty ()) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+  auto result = st_tree::tree<internals::ValueTypeOf<SmallMemoryTreeType> >{};
   result.insert (values.front ());
   if (values.size () == 1) // only one element which means tree with only a root node
     {
@@ -66,7 +105,7 @@ generateStTree (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMe
           if (auto const &expectedChildrenBeginAndEndIndex = internals::childrenBeginAndEndIndex (smallMemoryTree, i))
             {
               auto const &[childBegin, childEnd] = expectedChildrenBeginAndEndIndex.value ();
-              auto const &children = std::span{ values.begin () + boost::numeric_cast<int64_t> (childBegin), values.begin () + boost::numeric_cast<int64_t> (childEnd) };
+              auto const &children = values.subspan (childBegin, childEnd - childBegin);
               for (auto const &child : children)
                 {
                   itr->insert (child);
@@ -12,6 +12,7 @@ Distributed under the Boost Software License, Version 1.0.
 namespace small_memory_tree
 {
 
+// Node adapter for BaseTreeAdapter. StlplusTreeAdapter does not use it anymore. Kept for adapters which still derive from BaseTreeAdapter
 template <typename ValueType, typename NodeType> struct StlplusNodeAdapter : public BaseNodeAdapter<ValueType, NodeType>
 {
 
@@ -32,24 +33,68 @@ template <typename ValueType, typename NodeType> struct StlplusNodeAdapter : pub
   };
 };
 
-template <typename ValueType, typename NodeType = stlplus::ntree_node<ValueType>, typename TreeType = stlplus::ntree<ValueType> > struct StlplusTreeAdapter : public BaseTreeAdapter<StlplusNodeAdapter, ValueType, NodeType, TreeType>
+// Streams a stlplus::ntree breadth first into SmallMemoryTree without copying its nodes. tree has to outlive the adapter.
+// Can also be passed to generateSmallMemoryTreeParallel.
+template <typename ValueType, typename NodeType = stlplus::ntree_node<ValueType>, typename TreeType = stlplus::ntree<ValueType> > class StlplusTreeAdapter
 {
-  StlplusTreeAdapter (stlplus::ntree<ValueType> const &tree) : BaseTreeAdapter<StlplusNodeAdapter, ValueType, NodeType, TreeType>{ generateNodeAdapters (tree) } {}
-  std::vector<StlplusNodeAdapter<ValueType, NodeType> >
-  generateNodeAdapters (TreeType const &tree)
+public:
+  StlplusTreeAdapter (TreeType const &tree_) : tree{ &tree_ } {}
+
+  [[nodiscard]] uint64_t
+  nodeCount () const
   {
-    auto results = std::vector<StlplusNodeAdapter<ValueType, NodeType> >{};
-    std::ranges::transform (tree.breadth_first_traversal (), std::back_inserter (results), [] (auto const &nodeWrapper) { return StlplusNodeAdapter<ValueType, NodeType>{ *nodeWrapper.node () }; });
-    return results;
+    return boost::numeric_cast<uint64_t> (tree->size ());
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    if (tree->empty ()) return;
+    // breadth_first_traversal () would allocate an iterator for every node. The queue only holds the nodes of at most two levels
+    auto nodes = std::deque<NodeType const *>{ tree->root ().node () };
+    while (not nodes.empty ())
+      {
+        auto const *node = nodes.front ();
+        nodes.pop_front ();
+        visitor (node->m_data, boost::numeric_cast<uint64_t> (node->m_children.size ()));
+        nodes.insert (nodes.end (), node->m_children.begin (), node->m_children.end ());
+      }
+  }
+
+  // functions for generateSmallMemoryTreeParallel. Nodes are pointers to stlplus nodes
+  [[nodiscard]] NodeType *
+  root () const
+  {
+    return tree->root ().node ();
   }
+
+  [[nodiscard]] static std::vector<NodeType *> const &
+  children (NodeType const *node)
+  {
+    return node->m_children;
+  }
+
+  [[nodiscard]] static ValueType const &
+  value (NodeType const *node)
+  {
+    return node->m_data;
+  }
+
+private:
+  TreeType const *tree{};
 };
 
-template <typename ValueType, typename ChildrenOffsetEndType = uint64_t>
-inline std::expected<stlplus::ntree<ValueType>, std::error_condition>
-generateStlplusTree (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &smallMemoryTree)
+template <typename ValueType> StlplusTreeAdapter (stlplus::ntree<ValueType> const &) -> StlplusTreeAdapter<ValueType>;
+
+// Returns ApiError::OutOfRange for an empty tree because it has no root
+template <internals::IsSmallMemoryTree SmallMemoryTreeType>
+inline std::expected<stlplus::ntree<internals::ValueTypeOf<SmallMemoryTreeType> >, std::error_condition>
+generateStlplusTree (SmallMemoryTreeType const &smallMemoryTree)
 {
-  auto const &values = smallMemoryTree.getValues ();
-  auto result = stlplus::ntree<ValueType>{};
+  auto const &values = std::span{ smallMemoryTree.getValues () };
+  if (values.empty ()) return std::unexpected (make_error_condition (ApiError::OutOfRange));
+  auto result = stlplus::ntree<internals::ValueTypeOf<SmallMemoryTreeType> >{};
   auto parentNodes = std::deque{ result.insert (values.front ()) };
   auto currentLevelNodes = std::decay_t<decltype (parentNodes)>{};
   if (values.size () == 1) // only one element which means tree with only a root node
@@ -63,7 +108,7 @@ generateStlplusTree (SmallMemoryTree<ValueType, ChildrenOffsetEndType> const &sm
           if (auto const &expectedChildrenBeginAndEndIndex = internals::childrenBeginAndEndIndex (smallMemoryTree, i))
             {
               auto const &[childBegin, childEnd] = expectedChildrenBeginAndEndIndex.value ();
-              auto const &children = std::span{ values.begin () + boost::numeric_cast<int64_t> (childBegin), values.begin () + boost::numeric_cast<int64_t> (childEnd) };
+              auto const &children = values.subspan (childBegin, childEnd - childBegin);
               for (auto const &child : children)
                 {
                   currentLevelNodes.push_back (result.append (parentNodes.front (), child));
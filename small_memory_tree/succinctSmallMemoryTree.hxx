@@ -0,0 +1,286 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTree.hxx"
+#include <algorithm>
+#include <bit>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cstdint>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+namespace small_memory_tree
+{
+/*
+Elias-Fano encoding of a non decreasing sequence of unsigned integers with random access.
+Every element gets split into lowBitCount low bits which are stored packed and the high bits which are stored in unary in a bitvector (upperBits).
+The high bits of element i are the position of the i-th set bit in upperBits minus i.
+For childrenOffsetEnds the biggest element is nodeCount - 1 so lowBitCount is 0 and the sequence needs about 2 bits per element.
+operator[] needs one select on upperBits which takes constant time independent of the gaps between the set bits (for example the children count of a node):
+The set bits are grouped into blocks of onesPerBlock. A block whose set bits are far apart stores all their positions. Every other block stores the offset of every onesPerSubblock-th set bit
+and a subblock whose set bits are far apart stores all their offsets. What is left is a scan of at most maxScannedSubblockSpan bits and a select in one word.
+For childrenOffsetEnds the select index needs about 0.4 bits per element.
+*/
+class EliasFanoSequence
+{
+public:
+  EliasFanoSequence () = default;
+
+  // range gets iterated twice. Throws if range is not non decreasing or contains negative values
+  template <std::ranges::forward_range Range>
+  explicit EliasFanoSequence (Range const &range)
+  {
+    // the order gets checked before the bit arrays get sized with the last element
+    for (auto const &element : range)
+      {
+        auto const &value = boost::numeric_cast<uint64_t> (element);
+        if (elementCount != 0 and value < universe - 1) throw std::logic_error{ "EliasFanoSequence needs a non decreasing sequence" };
+        elementCount++;
+        universe = value + 1;
+      }
+    if (elementCount == 0) return;
+    lowBitCount = (universe > elementCount) ? boost::numeric_cast<uint64_t> (std::bit_width (universe / elementCount)) - 1 : 0;
+    lowBits.resize (wordCount (elementCount * lowBitCount));
+    upperBits.resize (wordCount (elementCount + (universe >> lowBitCount) + 1));
+    auto index = uint64_t{};
+    for (auto const &element : range)
+      {
+        auto const &value = boost::numeric_cast<uint64_t> (element);
+        setLowBits (index, value);
+        auto const &upperBitPosition = (value >> lowBitCount) + index;
+        upperBits.at (upperBitPosition / 64) |= uint64_t{ 1 } << (upperBitPosition % 64);
+        index++;
+      }
+    buildSelectIndex ();
+  }
+
+  [[nodiscard]] uint64_t
+  operator[] (uint64_t index) const
+  {
+    return ((selectUpperBits (index) - index) << lowBitCount) | getLowBits (index);
+  }
+
+  [[nodiscard]] uint64_t
+  size () const
+  {
+    return elementCount;
+  }
+
+  [[nodiscard]] bool
+  empty () const
+  {
+    return elementCount == 0;
+  }
+
+  // Heap memory used by the sequence in bytes
+  [[nodiscard]] uint64_t
+  memoryUsage () const
+  {
+    return (lowBits.capacity () + upperBits.capacity () + blockPositions.capacity () + blockInventory.capacity () + sparsePositions.capacity ()) * sizeof (uint64_t) + subblockOffsets.capacity () * sizeof (uint16_t);
+  }
+
+  // clang-format off
+    [[nodiscard]]
+  bool operator== (const EliasFanoSequence &) const = default;
+  // clang-format on
+
+private:
+  static constexpr uint64_t onesPerBlock = 1024;
+  static constexpr uint64_t onesPerSubblock = 64;
+  static constexpr uint64_t subblocksPerBlock = onesPerBlock / onesPerSubblock;
+  static constexpr uint64_t maxDenseBlockSpan = uint64_t{ 1 } << 15; // offsets in a dense block fit into 15 bits. The 16th bit marks explicit subblocks
+  static constexpr uint64_t maxScannedSubblockSpan = 512;
+  static constexpr uint64_t sparseBlockFlag = uint64_t{ 1 } << 63;
+  static constexpr uint16_t explicitSubblockFlag = uint16_t{ 1 } << 15;
+
+  [[nodiscard]] static constexpr uint64_t
+  wordCount (uint64_t bitCount)
+  {
+    return (bitCount + 63) / 64;
+  }
+
+  void
+  setLowBits (uint64_t index, uint64_t value)
+  {
+    if (lowBitCount == 0) return;
+    auto const &bitPosition = index * lowBitCount;
+    auto const &low = value & ((uint64_t{ 1 } << lowBitCount) - 1);
+    lowBits.at (bitPosition / 64) |= low << (bitPosition % 64);
+    if (bitPosition % 64 + lowBitCount > 64) lowBits.at (bitPosition / 64 + 1) |= low >> (64 - bitPosition % 64);
+  }
+
+  [[nodiscard]] uint64_t
+  getLowBits (uint64_t index) const
+  {
+    if (lowBitCount == 0) return 0;
+    auto const &bitPosition = index * lowBitCount;
+    auto result = lowBits[bitPosition / 64] >> (bitPosition % 64);
+    if (bitPosition % 64 + lowBitCount > 64) result |= lowBits[bitPosition / 64 + 1] << (64 - bitPosition % 64);
+    return result & ((uint64_t{ 1 } << lowBitCount) - 1);
+  }
+
+  void
+  buildSelectIndex ()
+  {
+    auto positions = std::vector<uint64_t>{};
+    positions.reserve (onesPerBlock);
+    for (auto wordIndex = uint64_t{}; wordIndex < upperBits.size (); ++wordIndex)
+      {
+        for (auto word = upperBits[wordIndex]; word != 0; word &= word - 1)
+          {
+            positions.push_back (wordIndex * 64 + static_cast<uint64_t> (std::countr_zero (word)));
+            if (positions.size () == onesPerBlock)
+              {
+                addBlock (positions);
+                positions.clear ();
+              }
+          }
+      }
+    if (not positions.empty ()) addBlock (positions);
+  }
+
+  // positions are the set bits of one block
+  void
+  addBlock (std::vector<uint64_t> const &positions)
+  {
+    auto const &blockPosition = positions.front ();
+    blockPositions.push_back (blockPosition);
+    if (positions.back () - blockPosition >= maxDenseBlockSpan)
+      {
+        blockInventory.push_back (sparseBlockFlag | sparsePositions.size ());
+        sparsePositions.insert (sparsePositions.end (), positions.begin (), positions.end ());
+        return;
+      }
+    auto const &subblocksBegin = uint64_t{ subblockOffsets.size () };
+    blockInventory.push_back (subblocksBegin);
+    subblockOffsets.resize (subblocksBegin + subblocksPerBlock);
+    auto explicitSubblockCount = uint16_t{};
+    for (auto first = uint64_t{}; first < positions.size (); first += onesPerSubblock)
+      {
+        auto const &last = std::min (first + onesPerSubblock, uint64_t{ positions.size () }) - 1;
+        auto &subblockOffset = subblockOffsets[subblocksBegin + first / onesPerSubblock];
+        if (positions[last] - positions[first] > maxScannedSubblockSpan)
+          {
+            // explicit subblocks of a block are stored after its subblockOffsets in the order of the subblocks
+            subblockOffset = explicitSubblockFlag | explicitSubblockCount++;
+            for (auto i = first; i <= last; ++i)
+              {
+                subblockOffsets.push_back (static_cast<uint16_t> (positions[i] - blockPosition));
+              }
+          }
+        else
+          {
+            subblockOffset = static_cast<uint16_t> (positions[first] - blockPosition);
+          }
+      }
+  }
+
+  // position of the set bit with number rank (counting from 0) in upperBits
+  [[nodiscard]] uint64_t
+  selectUpperBits (uint64_t rank) const
+  {
+    auto const &block = rank / onesPerBlock;
+    auto const &rankInBlock = rank % onesPerBlock;
+    auto const &inventory = blockInventory[block];
+    if ((inventory & sparseBlockFlag) != 0) return sparsePositions[(inventory & ~sparseBlockFlag) + rankInBlock];
+    auto const &subblockOffset = subblockOffsets[inventory + rankInBlock / onesPerSubblock];
+    if ((subblockOffset & explicitSubblockFlag) != 0)
+      {
+        auto const &explicitSubblock = uint64_t{ static_cast<uint16_t> (subblockOffset & ~explicitSubblockFlag) };
+        return blockPositions[block] + subblockOffsets[inventory + subblocksPerBlock + explicitSubblock * onesPerSubblock + rankInBlock % onesPerSubblock];
+      }
+    // the set bits of the subblock are at most maxScannedSubblockSpan bits apart
+    auto const &subblockPosition = blockPositions[block] + subblockOffset;
+    auto remaining = rankInBlock % onesPerSubblock;
+    auto wordIndex = subblockPosition / 64;
+    auto word = upperBits[wordIndex] & (~uint64_t{} << (subblockPosition % 64));
+    for (auto setBitCount = static_cast<uint64_t> (std::popcount (word)); setBitCount <= remaining; setBitCount = static_cast<uint64_t> (std::popcount (word)))
+      {
+        remaining -= setBitCount;
+        word = upperBits[++wordIndex];
+      }
+    return wordIndex * 64 + selectInWord (word, remaining);
+  }
+
+  // position of the set bit with number rank in word. word has more than rank set bits
+  [[nodiscard]] static uint64_t
+  selectInWord (uint64_t word, uint64_t rank)
+  {
+#if defined(__BMI2__)
+    return static_cast<uint64_t> (std::countr_zero (_pdep_u64 (uint64_t{ 1 } << rank, word)));
+#else
+    // broadword select: byte i of byteRanks is the number of set bits in the bytes 0 to i
+    constexpr auto onesStep8 = uint64_t{ 0x0101010101010101 };
+    constexpr auto highBits8 = uint64_t{ 0x8080808080808080 };
+    auto byteCounts = word - ((word >> 1) & uint64_t{ 0x5555555555555555 });
+    byteCounts = (byteCounts & uint64_t{ 0x3333333333333333 }) + ((byteCounts >> 2) & uint64_t{ 0x3333333333333333 });
+    byteCounts = (byteCounts + (byteCounts >> 4)) & uint64_t{ 0x0F0F0F0F0F0F0F0F };
+    auto const &byteRanks = byteCounts * onesStep8;
+    // number of bytes whose byteRanks is not bigger than rank is the byte of the set bit
+    auto const &byteIndex = static_cast<uint64_t> (std::popcount ((((rank * onesStep8) | highBits8) - byteRanks) & highBits8));
+    auto const &rankInByte = rank - ((byteIndex == 0) ? uint64_t{} : ((byteRanks >> (8 * byteIndex - 8)) & uint64_t{ 0xFF }));
+    auto byte = (word >> (8 * byteIndex)) & uint64_t{ 0xFF };
+    for (auto i = uint64_t{}; i < rankInByte; ++i)
+      {
+        byte &= byte - 1; // clears the lowest set bit
+      }
+    return 8 * byteIndex + static_cast<uint64_t> (std::countr_zero (byte));
+#endif
+  }
+
+  uint64_t elementCount{};
+  uint64_t universe{};
+  uint64_t lowBitCount{};
+  std::vector<uint64_t> lowBits{};
+  std::vector<uint64_t> upperBits{};
+  std::vector<uint64_t> blockPositions{};  // position of the first set bit of every block in upperBits
+  std::vector<uint64_t> blockInventory{};  // sparseBlockFlag and the begin of the block in sparsePositions or the begin of the block in subblockOffsets
+  std::vector<uint64_t> sparsePositions{}; // positions of all set bits of sparse blocks
+  std::vector<uint16_t> subblockOffsets{}; // per dense block subblocksPerBlock offsets to blockPositions followed by the offsets of all set bits of its explicit subblocks
+};
+
+// SmallMemoryTree which stores childrenOffsetEnds Elias-Fano encoded. Needs about 2.5 bits per node for the hierarchy instead of sizeof (ChildrenOffsetEndType) * 8.
+// getChildrenOffsetEnds ()[index] has to decode the value so lookups are slower than with SmallMemoryTree.
+template <typename ValueType> class SuccinctSmallMemoryTree
+{
+public:
+  SuccinctSmallMemoryTree () = default;
+
+  template <typename TreeAdapter>
+  requires internals::HasIteratorToNode<TreeAdapter> or internals::IsBreadthFirstSource<TreeAdapter>
+  SuccinctSmallMemoryTree (TreeAdapter const &treeAdapter) : SuccinctSmallMemoryTree{ SmallMemoryTree<ValueType>{ treeAdapter } } {}
+
+  template <internals::IsSmallMemoryTree SmallMemoryTreeType> explicit SuccinctSmallMemoryTree (SmallMemoryTreeType const &smallMemoryTree) : values (std::ranges::begin (smallMemoryTree.getValues ()), std::ranges::end (smallMemoryTree.getValues ())), childrenOffsetEnds{ smallMemoryTree.getChildrenOffsetEnds () } {}
+
+  template <typename ChildrenOffsetEndType> SuccinctSmallMemoryTree (std::vector<ValueType> values_, std::vector<ChildrenOffsetEndType> const &childrenOffsetEnds_) : values{ std::move (values_) }, childrenOffsetEnds{ childrenOffsetEnds_ } {}
+
+  // clang-format off
+    [[nodiscard]]
+  bool operator== (const SuccinctSmallMemoryTree &) const = default;
+  // clang-format on
+
+  [[nodiscard]] std::vector<ValueType> const &
+  getValues () const
+  {
+    return values;
+  }
+
+  [[nodiscard]] EliasFanoSequence const &
+  getChildrenOffsetEnds () const
+  {
+    return childrenOffsetEnds;
+  }
+
+private:
+  std::vector<ValueType> values{};
+  EliasFanoSequence childrenOffsetEnds{};
+};
+}
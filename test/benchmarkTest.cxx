@@ -4,12 +4,28 @@
 (See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
   */
 
+#include "countAllocations.hxx"
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/parallelSmallMemoryTree.hxx"
+#include "small_memory_tree/smallMemoryTreeBatch.hxx"
 #include "small_memory_tree/stTree.hxx"
+#include <array>
 #include <catch2/catch.hpp>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 using namespace small_memory_tree;
 
+template <typename Function>
+uint64_t
+countAllocations (Function &&function)
+{
+  auto const &allocationCountBefore = test::allocationCount ();
+  function ();
+  return test::allocationCount () - allocationCountBefore;
+}
+
 TEST_CASE ("SmallMemoryTree calcChildrenForPath", "[!benchmark]")
 {
   SECTION ("few elements")
@@ -87,9 +103,104 @@ TEST_CASE ("SmallMemoryTree calcChildrenForPath", "[!benchmark]")
     {
       BENCHMARK ("SmallMemoryTree") { return calcChildrenForPath (smallMemoryTree, std::vector<uint64_t>{ 0, 9999 }, true); };
     }
+    SECTION ("calcChildrenForPath last element with EytzingerIndex 0 9999 ")
+    {
+      auto const &eytzingerIndex = EytzingerIndex<uint64_t>{ smallMemoryTree };
+      BENCHMARK ("SmallMemoryTree") { return calcChildrenIndexForPath (smallMemoryTree, { 0, 9999 }, eytzingerIndex); };
+      BENCHMARK ("SmallMemoryTree binary find") { return calcChildrenIndexForPath (smallMemoryTree, { 0, 9999 }, true); };
+    }
+  }
+}
+
+TEST_CASE ("SmallMemoryTree calcChildrenSpanForPath", "[!benchmark]")
+{
+  auto tree = st_tree::tree<uint64_t>{};
+  tree.insert (0);
+  for (auto i = uint64_t{}; i < 100; ++i)
+    {
+      tree.root ().insert (i);
+      tree.root ()[i].insert (i);
+    }
+  auto smallMemoryTree = SmallMemoryTree<uint64_t>{ StTreeAdapter{ tree } };
+  SECTION ("calcChildrenForPath vs calcChildrenSpanForPath 0 99")
+  {
+    BENCHMARK ("calcChildrenForPath") { return calcChildrenForPath (smallMemoryTree, std::vector<uint64_t>{ 0, 99 }); };
+    BENCHMARK ("calcChildrenSpanForPath") { return calcChildrenSpanForPath (smallMemoryTree, { 0, 99 }); };
+    BENCHMARK ("calcChildrenIndexForPath") { return calcChildrenIndexForPath (smallMemoryTree, { 0, 99 }); };
   }
 }
 
+TEST_CASE ("SmallMemoryTree calcChildrenForPath allocations")
+{
+  auto tree = st_tree::tree<uint64_t>{};
+  tree.insert (0);
+  for (auto i = uint64_t{}; i < 100; ++i)
+    {
+      tree.root ().insert (i);
+      tree.root ()[i].insert (i);
+    }
+  auto smallMemoryTree = SmallMemoryTree<uint64_t>{ StTreeAdapter{ tree } };
+  auto const &path = std::array<uint64_t, 2>{ 0, 99 };
+  SECTION ("calcChildrenForPath allocates for path and result") { REQUIRE (countAllocations ([&] { [[maybe_unused]] auto result = calcChildrenForPath (smallMemoryTree, std::vector<uint64_t> (path.begin (), path.end ())); }) == 2); }
+  SECTION ("calcChildrenSpanForPath does not allocate") { REQUIRE (countAllocations ([&] { [[maybe_unused]] auto result = calcChildrenSpanForPath (smallMemoryTree, path); }) == 0); }
+  SECTION ("calcChildrenIndexForPath does not allocate") { REQUIRE (countAllocations ([&] { [[maybe_unused]] auto result = calcChildrenIndexForPath (smallMemoryTree, { 0, 99 }); }) == 0); }
+}
+
+TEST_CASE ("SmallMemoryTree construction", "[!benchmark]")
+{
+  // 1000 * 1000 nodes on the third level
+  auto tree = st_tree::tree<uint64_t>{};
+  tree.insert (0);
+  for (auto i = uint64_t{}; i < 1000; ++i)
+    {
+      tree.root ().insert (i);
+      for (auto j = uint64_t{}; j < 1000; ++j)
+        {
+          tree.root ()[i].insert (j);
+        }
+    }
+  BENCHMARK ("serial") { return SmallMemoryTree<uint64_t>{ StTreeAdapter{ tree } }; };
+  for (auto const &threadCount : { uint64_t{ 1 }, uint64_t{ 2 }, uint64_t{ 4 }, uint64_t{ 8 }, uint64_t{ 16 } })
+    {
+      BENCHMARK ("parallel " + std::to_string (threadCount) + " threads") { return generateSmallMemoryTreeParallel<uint64_t> (StTreeAdapter{ tree }, threadCount); };
+    }
+}
+
+TEST_CASE ("SmallMemoryTree calcChildrenIndexForPaths", "[!benchmark]")
+{
+  // 1000 * 1000 nodes on the third level
+  auto tree = st_tree::tree<uint64_t>{};
+  tree.insert (0);
+  for (auto i = uint64_t{}; i < 1000; ++i)
+    {
+      tree.root ().insert (i);
+      for (auto j = uint64_t{}; j < 1000; ++j)
+        {
+          tree.root ()[i].insert (j);
+        }
+    }
+  auto const &smallMemoryTree = SmallMemoryTree<uint64_t>{ StTreeAdapter{ tree } };
+  auto paths = std::vector<std::vector<uint64_t> >{};
+  for (auto i = uint64_t{}; i < 100000; ++i)
+    {
+      paths.push_back ({ 0, (i * 7919) % 1000, (i * 104729) % 1000 });
+    }
+  BENCHMARK ("calcChildrenIndexForPath for every path")
+  {
+    auto results = std::vector<std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition> >{};
+    results.reserve (paths.size ());
+    for (auto const &path : paths)
+      {
+        results.push_back (calcChildrenIndexForPath (smallMemoryTree, path, true));
+      }
+    return results;
+  };
+  for (auto const &threadCount : { uint64_t{ 1 }, uint64_t{ 2 }, uint64_t{ 4 }, uint64_t{ 8 } })
+    {
+      BENCHMARK ("calcChildrenIndexForPaths " + std::to_string (threadCount) + " threads") { return calcChildrenIndexForPaths (smallMemoryTree, paths, true, threadCount); };
+    }
+}
+
 TEST_CASE ("st_tree find node", "[!benchmark]")
 {
   SECTION ("find in 10000 elements")
@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/compactSmallMemoryTree.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <numeric>
+#include <variant>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root with childrenCount children
+SmallMemoryTree<int64_t>
+wideTree (uint64_t childrenCount)
+{
+  auto values = std::vector<int64_t> (childrenCount + 1);
+  std::iota (values.begin (), values.end (), int64_t{});
+  return SmallMemoryTree<int64_t>{ values, std::vector<uint64_t> (childrenCount + 1, childrenCount) };
+}
+
+// same tree as wideTree without nodeCount
+struct WideTreeSource
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = uint64_t{}; i <= childrenCount; ++i)
+      {
+        visitor (static_cast<int64_t> (i), (i == 0) ? childrenCount : 0);
+      }
+  }
+
+  uint64_t childrenCount{};
+};
+
+struct WideTreeSourceWithNodeCount : WideTreeSource
+{
+  uint64_t
+  nodeCount () const
+  {
+    return childrenCount + 1;
+  }
+};
+}
+
+TEST_CASE ("compact")
+{
+  REQUIRE (std::holds_alternative<SmallMemoryTree<int64_t, uint8_t> > (compact (wideTree (255))));
+  REQUIRE (std::holds_alternative<SmallMemoryTree<int64_t, uint16_t> > (compact (wideTree (256))));
+  REQUIRE (std::holds_alternative<SmallMemoryTree<int64_t, uint32_t> > (compact (wideTree (70000))));
+  auto const &smallMemoryTree = wideTree (300);
+  auto const &compactSmallMemoryTree = compact (smallMemoryTree);
+  REQUIRE (std::get<SmallMemoryTree<int64_t, uint16_t> > (compactSmallMemoryTree).getValues () == smallMemoryTree.getValues ());
+  SECTION ("lookups dispatch to the stored tree")
+  {
+    REQUIRE (calcChildrenIndexForPath (compactSmallMemoryTree, { 0, 300 }) == calcChildrenIndexForPath (smallMemoryTree, { 0, 300 }));
+    REQUIRE (calcChildrenSpanForPath (compactSmallMemoryTree, { 0 }).value ().size () == 300);
+    REQUIRE (calcChildrenForPath (compactSmallMemoryTree, { 0 }, true).value () == calcChildrenForPath (smallMemoryTree, { 0 }).value ());
+    REQUIRE (calcChildrenForPath (compactSmallMemoryTree, { 1 }).error () == ApiError::PathDoesNotMatch);
+  }
+}
+
+TEST_CASE ("makeCompactSmallMemoryTree")
+{
+  SECTION ("with nodeCount") { REQUIRE (std::holds_alternative<SmallMemoryTree<int64_t, uint8_t> > (makeCompactSmallMemoryTree<int64_t> (WideTreeSourceWithNodeCount{ 255 }))); }
+  SECTION ("without nodeCount")
+  {
+    auto const &compactSmallMemoryTree = makeCompactSmallMemoryTree<int64_t> (WideTreeSource{ 256 });
+    REQUIRE (std::get<SmallMemoryTree<int64_t, uint16_t> > (compactSmallMemoryTree).getChildrenOffsetEnds () == convertChildrenOffsetEndType<uint16_t> (wideTree (256)).value ().getChildrenOffsetEnds ());
+  }
+}
+
+TEST_CASE ("convert between widths")
+{
+  auto const &smallMemoryTree = wideTree (300);
+  REQUIRE (convertChildrenOffsetEndType<uint8_t> (smallMemoryTree).error () == ApiError::OutOfRange);
+  REQUIRE (convertChildrenOffsetEndType<uint64_t> (convertChildrenOffsetEndType<uint16_t> (smallMemoryTree).value ()).value () == smallMemoryTree);
+  REQUIRE (convertValueType<int8_t> (smallMemoryTree).error () == ApiError::OutOfRange);
+  REQUIRE (convertValueType<int16_t> (smallMemoryTree).value ().getValues ().back () == 300);
+  REQUIRE (convertValueType<int64_t> (convertValueType<uint16_t> (smallMemoryTree).value ()).value () == smallMemoryTree);
+}
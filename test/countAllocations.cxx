@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "countAllocations.hxx"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> allocationCounter{};
+}
+
+uint64_t
+test::allocationCount ()
+{
+  return allocationCounter.load ();
+}
+
+void *
+operator new (std::size_t size)
+{
+  ++allocationCounter;
+  if (auto *memory = std::malloc (size == 0 ? 1 : size)) return memory;
+  throw std::bad_alloc{};
+}
+
+void *
+operator new (std::size_t size, std::nothrow_t const &) noexcept
+{
+  ++allocationCounter;
+  return std::malloc (size == 0 ? 1 : size);
+}
+
+void
+operator delete (void *memory) noexcept
+{
+  std::free (memory);
+}
+
+void
+operator delete (void *memory, std::size_t) noexcept
+{
+  std::free (memory);
+}
+
+void
+operator delete (void *memory, std::nothrow_t const &) noexcept
+{
+  std::free (memory);
+}
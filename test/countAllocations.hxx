@@ -0,0 +1,14 @@
+#pragma once
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+
+namespace test
+{
+// Number of calls to the global operator new since program start. Replaced operator new lives in countAllocations.cxx
+uint64_t allocationCount ();
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root with childrenCount sorted children. The child with value 2 has childrenCount sorted children too
+template <typename ValueType>
+SmallMemoryTree<ValueType>
+wideTree (uint64_t childrenCount)
+{
+  auto values = std::vector<ValueType>{ ValueType{} };
+  for (auto i = uint64_t{}; i < childrenCount; ++i)
+    {
+      values.push_back (static_cast<ValueType> (i * 2));
+    }
+  for (auto i = uint64_t{}; i < childrenCount; ++i)
+    {
+      values.push_back (static_cast<ValueType> (i * 3));
+    }
+  auto childrenCounts = std::vector<uint64_t> (values.size ());
+  childrenCounts.at (0) = childrenCount;
+  if (childrenCount > 1) childrenCounts.at (2) = childrenCount;
+  auto childrenOffsetEnds = std::vector<uint64_t> (values.size ());
+  std::partial_sum (childrenCounts.begin (), childrenCounts.end (), childrenOffsetEnds.begin ());
+  if (childrenCount <= 1) values.resize (childrenCount + 1);
+  if (childrenCount <= 1) childrenOffsetEnds.resize (childrenCount + 1);
+  return SmallMemoryTree<ValueType>{ values, childrenOffsetEnds };
+}
+}
+
+TEMPLATE_TEST_CASE ("EytzingerIndex same result as binary find", "", uint8_t, uint32_t, int64_t)
+{
+  for (auto const &childrenCount : { uint64_t{ 1 }, uint64_t{ 7 }, uint64_t{ 64 }, uint64_t{ 65 }, uint64_t{ 100 }, uint64_t{ 127 } })
+    {
+      if (childrenCount * 3 > static_cast<uint64_t> (std::numeric_limits<TestType>::max ())) continue; // values would not be sorted
+      INFO ("childrenCount " << childrenCount);
+      auto const &smallMemoryTree = wideTree<TestType> (childrenCount);
+      auto const &eytzingerIndex = EytzingerIndex<TestType>{ smallMemoryTree, 1 };
+      REQUIRE (eytzingerIndex.indexedNodeCount () == ((childrenCount > 1) ? 2 : 1));
+      for (auto value = TestType{}; value < static_cast<TestType> (std::min<uint64_t> (127, childrenCount * 3 + 2)); ++value)
+        {
+          INFO ("value " << static_cast<int64_t> (value));
+          REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { TestType{}, value }, eytzingerIndex) == calcChildrenIndexForPath (smallMemoryTree, { TestType{}, value }, true));
+          if (childrenCount > 1) REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { TestType{}, TestType{ 2 }, value }, eytzingerIndex) == calcChildrenIndexForPath (smallMemoryTree, { TestType{}, TestType{ 2 }, value }, true));
+        }
+    }
+}
+
+TEST_CASE ("EytzingerIndex")
+{
+  auto const &smallMemoryTree = wideTree<uint64_t> (10000);
+  auto const &eytzingerIndex = EytzingerIndex<uint64_t>{ smallMemoryTree };
+  SECTION ("children in logical order")
+  {
+    auto const &children = calcChildrenSpanForPath (smallMemoryTree, { 0 }, eytzingerIndex);
+    REQUIRE (children);
+    REQUIRE (std::ranges::is_sorted (children.value ()));
+    REQUIRE (calcChildrenForPath (smallMemoryTree, { 0, 2 }, eytzingerIndex).value () == calcChildrenForPath (smallMemoryTree, { 0, 2 }).value ());
+  }
+  SECTION ("find every child")
+  {
+    for (auto value = uint64_t{}; value < 20000; value += 2)
+      {
+        REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0, value }, eytzingerIndex));
+        REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0, value + 1 }, eytzingerIndex).error () == ApiError::PathDoesNotMatch);
+      }
+  }
+  SECTION ("small nodes are not indexed") { REQUIRE (EytzingerIndex<uint64_t>{ wideTree<uint64_t> (8) }.indexedNodeCount () == 0); }
+  SECTION ("unsorted nodes are not indexed")
+  {
+    auto const &unsortedSmallMemoryTree = SmallMemoryTree<std::string>{ std::vector<std::string>{ "root", "c", "b", "a" }, std::vector<uint64_t>{ 3, 3, 3, 3 } };
+    auto const &unsortedEytzingerIndex = EytzingerIndex<std::string>{ unsortedSmallMemoryTree, 1 };
+    REQUIRE (unsortedEytzingerIndex.indexedNodeCount () == 0);
+    REQUIRE (calcChildrenForPath (unsortedSmallMemoryTree, { "root", "c" }).value ().empty ());
+    for (auto const &value : { "a", "b", "c", "d" })
+      {
+        INFO ("value " << value);
+        REQUIRE (calcChildrenIndexForPath (unsortedSmallMemoryTree, { "root", value }, unsortedEytzingerIndex) == calcChildrenIndexForPath (unsortedSmallMemoryTree, { "root", value }, true));
+      }
+  }
+}
+
+TEST_CASE ("EytzingerIndex duplicate children across block boundaries")
+{
+  // runs of 70 equal children so every run crosses a block of 64 uint8_t
+  auto values = std::vector<uint8_t>{ 0 };
+  for (auto i = uint64_t{}; i < 350; ++i)
+    {
+      values.push_back (static_cast<uint8_t> (i / 70 + 1));
+    }
+  auto childrenOffsetEnds = std::vector<uint64_t> (values.size (), 350);
+  auto const &smallMemoryTree = SmallMemoryTree<uint8_t>{ values, childrenOffsetEnds };
+  auto const &eytzingerIndex = EytzingerIndex<uint8_t>{ smallMemoryTree, 1 };
+  REQUIRE (eytzingerIndex.indexedNodeCount () == 1);
+  for (auto value = uint8_t{}; value < 8; ++value)
+    {
+      INFO ("value " << int{ value });
+      REQUIRE (eytzingerIndex.findChild (std::span<uint8_t const>{ smallMemoryTree.getValues () }, 1, 351, value) == internals::findChild (true, std::span<uint8_t const>{ smallMemoryTree.getValues () }, 1, 351, value));
+    }
+}
+
+TEST_CASE ("EytzingerIndex costs nothing for nodes which are not indexed")
+{
+  // the root has 100000 unsorted children. Only its last child with 64 sorted children is indexed
+  auto values = std::vector<uint64_t>{ 0 };
+  for (auto i = uint64_t{}; i < 100000; ++i)
+    {
+      values.push_back (100000 - i);
+    }
+  for (auto i = uint64_t{}; i < 64; ++i)
+    {
+      values.push_back (i * 2);
+    }
+  auto childrenOffsetEnds = std::vector<uint64_t> (values.size (), 100064);
+  childrenOffsetEnds.at (0) = 100000;
+  auto const &smallMemoryTree = SmallMemoryTree<uint64_t>{ values, childrenOffsetEnds };
+  auto const &eytzingerIndex = EytzingerIndex<uint64_t>{ smallMemoryTree, 64 };
+  REQUIRE (eytzingerIndex.indexedNodeCount () == 1);
+  // 8 samples with their block numbers, the childrenBeginIndex and the two samplesBegins
+  REQUIRE (eytzingerIndex.memoryUsage () == 9 * (sizeof (uint64_t) + sizeof (uint32_t)) + 3 * sizeof (uint64_t));
+  for (auto value = uint64_t{}; value < 130; ++value)
+    {
+      INFO ("value " << value);
+      REQUIRE (eytzingerIndex.findChild (std::span<uint64_t const>{ smallMemoryTree.getValues () }, 100001, 100065, value) == internals::findChild (true, std::span<uint64_t const>{ smallMemoryTree.getValues () }, 100001, 100065, value));
+    }
+}
@@ -0,0 +1,69 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/fixedSmallMemoryTree.hxx"
+#include "small_memory_tree/smallMemoryTreeCursor.hxx"
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+constexpr auto treeLiteral = TreeLiteral<int>{ 0, { { 1, { { 3 }, { 4 } } }, { 2, { { 5 }, { 6, { { 7 } } } } } } };
+constexpr auto fixedSmallMemoryTree = FixedSmallMemoryTree<int, treeLiteral.nodeCount ()>{ treeLiteral };
+auto const smallMemoryTree = SmallMemoryTree<int, uint8_t>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+}
+
+static_assert (std::same_as<std::remove_cvref_t<decltype (fixedSmallMemoryTree.getChildrenOffsetEnds ()[0])>, uint8_t>);
+static_assert (std::ranges::equal (fixedSmallMemoryTree.getValues (), std::array{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+static_assert (std::ranges::equal (fixedSmallMemoryTree.getChildrenOffsetEnds (), std::array<uint8_t, 8>{ 2, 4, 6, 6, 6, 6, 7, 7 }));
+static_assert (fixedSmallMemoryTree == FixedSmallMemoryTree{ std::array{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::array<uint8_t, 8>{ 2, 4, 6, 6, 6, 6, 7, 7 } });
+static_assert (FixedSmallMemoryTree<int, 1>{ TreeLiteral<int>{ 42 } }.getValues ().front () == 42);
+
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, { 0, 2, 6 }).value () == std::tuple<uint64_t, uint64_t>{ 7, 8 });
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, { 0, 2, 6 }, true).value () == std::tuple<uint64_t, uint64_t>{ 7, 8 });
+static_assert (calcChildrenSpanForPath (fixedSmallMemoryTree, { 0, 1 })->size () == 2);
+static_assert (calcChildrenSpanForPath (fixedSmallMemoryTree, std::array{ 0, 2 })->front () == 5);
+static_assert (calcChildrenForPath (fixedSmallMemoryTree, { 0, 2 }).value () == std::vector<int>{ 5, 6 });
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, { 0, 2, 6, 7, 8 }).error () == ApiError::PathTooLong);
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, { 0, 3 }).error () == ApiError::PathDoesNotMatch);
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, { 1 }).error () == ApiError::PathDoesNotMatch);
+static_assert (calcChildrenIndexForPath (fixedSmallMemoryTree, std::array<int, 0>{}).error () == ApiError::EmptyPath);
+static_assert (calcChildrenIndexForPath (FixedSmallMemoryTree<int, 0>{}, { 0 }).error () == ApiError::PathDoesNotMatch);
+
+// the span points into the tree so it can be a constant too
+constexpr auto childrenOfTwo = calcChildrenSpanForPath (fixedSmallMemoryTree, { 0, 2 });
+static_assert (childrenOfTwo->data () == fixedSmallMemoryTree.getValues ().data () + 5);
+
+TEST_CASE ("FixedSmallMemoryTree")
+{
+  SECTION ("same as SmallMemoryTree at runtime")
+  {
+    auto path = std::vector<int>{ 0 };
+    for (auto const &value : { 2, 6, 7, 9 })
+      {
+        REQUIRE (calcChildrenIndexForPath (fixedSmallMemoryTree, path) == calcChildrenIndexForPath (smallMemoryTree, path));
+        REQUIRE (calcChildrenForPath (fixedSmallMemoryTree, path, true) == calcChildrenForPath (smallMemoryTree, path, true));
+        path.push_back (value);
+      }
+  }
+  SECTION ("works with the functions for IsSmallMemoryTree")
+  {
+    REQUIRE (calcChildrenIndexForPath (fixedSmallMemoryTree, { 0, 2, 6 }, EytzingerIndex<int>{ fixedSmallMemoryTree, 1 }).value () == std::tuple<uint64_t, uint64_t>{ 7, 8 });
+    REQUIRE (Cursor{ fixedSmallMemoryTree }.child (2)->child (6)->getIndex () == 6);
+  }
+  SECTION ("TreeLiteral with a different node count")
+  {
+    REQUIRE_THROWS_AS ((FixedSmallMemoryTree<int, 7>{ treeLiteral }), std::logic_error);
+    REQUIRE_THROWS_AS ((FixedSmallMemoryTree<int, 9>{ treeLiteral }), std::logic_error);
+  }
+}
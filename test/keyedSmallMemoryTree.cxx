@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/keyedSmallMemoryTree.hxx"
+#include "small_memory_tree/smallMemoryTreeBatch.hxx"
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+using Payload = std::array<char, 60>;
+
+Payload
+makePayload (uint32_t id)
+{
+  auto payload = Payload{};
+  payload.fill (static_cast<char> ('a' + id));
+  return payload;
+}
+
+// root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+auto const keys = std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5, 6, 7 };
+auto const payloads = std::vector<Payload>{ makePayload (0), makePayload (1), makePayload (2), makePayload (3), makePayload (4), makePayload (5), makePayload (6), makePayload (7) };
+auto const childrenOffsetEnds = std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 };
+
+std::vector<std::pair<uint32_t, Payload> >
+keysAndPayloads ()
+{
+  auto result = std::vector<std::pair<uint32_t, Payload> >{};
+  for (auto i = uint64_t{}; i < keys.size (); ++i)
+    {
+      result.emplace_back (keys.at (i), payloads.at (i));
+    }
+  return result;
+}
+
+struct KeyAndPayloadSource
+{
+  uint64_t
+  nodeCount () const
+  {
+    return keys.size ();
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = uint64_t{}; i < keys.size (); ++i)
+      {
+        visitor (std::pair{ keys.at (i), payloads.at (i) }, uint64_t{ childrenOffsetEnds.at (i) } - ((i == 0) ? uint64_t{} : childrenOffsetEnds.at (i - 1)));
+      }
+  }
+};
+
+// a record which stores its key like the records of a database
+struct Record
+{
+  uint32_t id{};
+  Payload data{};
+};
+
+struct RecordSource
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = uint64_t{}; i < keys.size (); ++i)
+      {
+        visitor (Record{ keys.at (i), payloads.at (i) }, uint64_t{ childrenOffsetEnds.at (i) } - ((i == 0) ? uint64_t{} : childrenOffsetEnds.at (i - 1)));
+      }
+  }
+};
+
+// node i has the child i + 1
+struct ChainSource
+{
+  uint64_t chainLength{};
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = uint64_t{}; i < chainLength; ++i)
+      {
+        visitor (std::pair{ static_cast<uint32_t> (i), Payload{} }, uint64_t{ (i + 1 == chainLength) ? 0U : 1U });
+      }
+  }
+};
+}
+
+TEST_CASE ("KeyedSmallMemoryTree")
+{
+  auto const &keyedSmallMemoryTree = KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ keys, payloads, childrenOffsetEnds };
+  SECTION ("keys and payloads get stored in their own columns")
+  {
+    REQUIRE (keyedSmallMemoryTree.getValues () == keys);
+    REQUIRE (keyedSmallMemoryTree.getPayloads () == payloads);
+    REQUIRE (keyedSmallMemoryTree.getChildrenOffsetEnds () == childrenOffsetEnds);
+    REQUIRE_THROWS_AS ((KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ keys, std::vector<Payload>{}, childrenOffsetEnds }), std::logic_error);
+  }
+  SECTION ("construction")
+  {
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ KeyAndPayloadSource{} } == keyedSmallMemoryTree);
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ SmallMemoryTree<std::pair<uint32_t, Payload>, uint8_t>{ keysAndPayloads (), childrenOffsetEnds } } == keyedSmallMemoryTree);
+    REQUIRE_THROWS ((KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ ChainSource{ 300 } }));
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ RecordSource{}, &Record::id, &Record::data } == keyedSmallMemoryTree);
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ RecordSource{}, [] (Record const &record) { return record.id; }, [] (Record const &record) { return record.data; } } == keyedSmallMemoryTree);
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint16_t>{ ChainSource{ 300 } }.getChildrenOffsetEnds ().back () == 299);
+    auto records = std::vector<Record>{};
+    std::ranges::transform (keysAndPayloads (), std::back_inserter (records), [] (auto const &keyAndPayload) { return Record{ keyAndPayload.first, keyAndPayload.second }; });
+    REQUIRE (KeyedSmallMemoryTree<uint32_t, Payload, uint8_t>{ SmallMemoryTree<Record, uint8_t>{ records, childrenOffsetEnds }, &Record::id, &Record::data } == keyedSmallMemoryTree);
+  }
+  SECTION ("lookup functions take paths of keys")
+  {
+    REQUIRE (calcChildrenForPath (keyedSmallMemoryTree, { 0, 2 }).value () == std::vector<uint32_t>{ 5, 6 });
+    REQUIRE (calcChildrenIndexForPath (keyedSmallMemoryTree, { 0, 2, 6 }, true) == calcChildrenIndexForPath (SmallMemoryTree<uint32_t, uint8_t>{ keys, childrenOffsetEnds }, { 0, 2, 6 }));
+    REQUIRE (calcChildrenIndexForPath (keyedSmallMemoryTree, { 0, 2, 6 }, EytzingerIndex<uint32_t>{ keyedSmallMemoryTree, 1 }).value () == std::tuple<uint64_t, uint64_t>{ 7, 8 });
+    REQUIRE (calcChildrenIndexForPaths (keyedSmallMemoryTree, std::vector<std::vector<uint32_t> >{ { 0, 1 }, { 0, 3 } }).at (1).error () == ApiError::PathDoesNotMatch);
+  }
+  SECTION ("calcPayloadForPath")
+  {
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, { 0 }).value () == payloads.at (0));
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, { 0, 2, 6, 7 }).value () == payloads.at (7));
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, std::array<uint32_t, 3>{ 0, 1, 4 }, true).value () == payloads.at (4));
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, { 0, 2, 6, 7, 8 }).error () == ApiError::PathTooLong);
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, { 0, 3 }).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, { 1 }).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (calcPayloadForPath (keyedSmallMemoryTree, std::vector<uint32_t>{}).error () == ApiError::EmptyPath);
+  }
+  SECTION ("calcChildrenPayloadSpanForPath")
+  {
+    auto const childrenPayloads = calcChildrenPayloadSpanForPath (keyedSmallMemoryTree, { 0, 1 }).value ();
+    REQUIRE (childrenPayloads.data () == keyedSmallMemoryTree.getPayloads ().data () + 3);
+    REQUIRE (std::ranges::equal (childrenPayloads, std::vector<Payload>{ payloads.at (3), payloads.at (4) }));
+    REQUIRE (calcChildrenPayloadSpanForPath (keyedSmallMemoryTree, { 0, 1, 3 }).value ().empty ());
+    REQUIRE (calcChildrenPayloadSpanForPath (keyedSmallMemoryTree, { 0, 9 }).error () == ApiError::PathDoesNotMatch);
+  }
+  SECTION ("empty tree")
+  {
+    auto const &emptyTree = KeyedSmallMemoryTree<uint32_t, Payload>{};
+    REQUIRE (calcPayloadForPath (emptyTree, { 0 }).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (calcChildrenPayloadSpanForPath (emptyTree, { 0 }).error () == ApiError::PathDoesNotMatch);
+  }
+}
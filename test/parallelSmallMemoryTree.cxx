@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/parallelSmallMemoryTree.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// Tree where every node is an index into childrenOfNodes. Is a BreadthFirstSource and a LevelSource
+struct IndexTree
+{
+  uint64_t
+  nodeCount () const
+  {
+    return childrenOfNodes.size ();
+  }
+
+  uint64_t
+  root () const
+  {
+    return 0;
+  }
+
+  std::vector<uint64_t> const &
+  children (uint64_t node) const
+  {
+    return childrenOfNodes.at (node);
+  }
+
+  uint64_t
+  value (uint64_t node) const
+  {
+    return node * 7;
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    auto nodes = std::deque<uint64_t>{ root () };
+    while (not nodes.empty ())
+      {
+        auto const node = nodes.front ();
+        nodes.pop_front ();
+        visitor (value (node), children (node).size ());
+        nodes.insert (nodes.end (), children (node).begin (), children (node).end ());
+      }
+  }
+
+  std::vector<std::vector<uint64_t> > childrenOfNodes{};
+};
+
+IndexTree
+randomTree (uint64_t nodeCount, uint64_t seed)
+{
+  auto randomNumberGenerator = std::mt19937_64{ seed };
+  auto result = IndexTree{ std::vector<std::vector<uint64_t> > (nodeCount) };
+  for (auto node = uint64_t{ 1 }; node < nodeCount; ++node)
+    {
+      result.childrenOfNodes.at (std::uniform_int_distribution<uint64_t>{ 0, node - 1 }(randomNumberGenerator)).push_back (node);
+    }
+  return result;
+}
+}
+
+TEST_CASE ("parallelInclusiveScan")
+{
+  for (auto const &size : { uint64_t{}, uint64_t{ 1 }, uint64_t{ 3 }, uint64_t{ 1000 } })
+    {
+      auto values = std::vector<uint64_t> (size);
+      std::iota (values.begin (), values.end (), uint64_t{});
+      auto expected = std::vector<uint64_t> (size);
+      std::inclusive_scan (values.begin (), values.end (), expected.begin ());
+      internals::parallelInclusiveScan (values, 7);
+      REQUIRE (values == expected);
+    }
+}
+
+TEST_CASE ("generateSmallMemoryTreeParallel")
+{
+  SECTION ("same result as serial construction")
+  {
+    for (auto const &nodeCount : { uint64_t{ 1 }, uint64_t{ 2 }, uint64_t{ 100 }, uint64_t{ 10000 } })
+      {
+        auto const &indexTree = randomTree (nodeCount, nodeCount);
+        auto const &smallMemoryTree = SmallMemoryTree<uint64_t>{ indexTree };
+        for (auto const &threadCount : { uint64_t{ 1 }, uint64_t{ 2 }, uint64_t{ 3 }, uint64_t{ 8 } })
+          {
+            INFO ("nodeCount " << nodeCount << " threadCount " << threadCount);
+            REQUIRE (generateSmallMemoryTreeParallel<uint64_t> (indexTree, threadCount, 1) == smallMemoryTree);
+          }
+      }
+  }
+  SECTION ("empty tree") { REQUIRE (generateSmallMemoryTreeParallel<uint64_t> (IndexTree{}, 4).getValues ().empty ()); }
+  SECTION ("ChildrenOffsetEndType too small") { REQUIRE_THROWS (generateSmallMemoryTreeParallel<uint64_t, uint8_t> (randomTree (1000, 42), 4, 1)); }
+}
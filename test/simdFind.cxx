@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/simdFind.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace small_memory_tree::internals;
+
+namespace
+{
+std::vector<SimdLevel>
+supportedSimdLevels ()
+{
+  auto results = std::vector<SimdLevel>{ SimdLevel::Scalar };
+  for (auto const &level : { SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 })
+    {
+      if (static_cast<int> (level) <= static_cast<int> (simdLevel ())) results.push_back (level);
+    }
+  return results;
+}
+}
+
+TEMPLATE_TEST_CASE ("simdFind", "", uint8_t, int16_t, uint32_t, int64_t)
+{
+  for (auto const &level : supportedSimdLevels ())
+    {
+      INFO ("simd level " << static_cast<int> (level));
+      for (auto size = size_t{}; size < 150; ++size)
+        {
+          auto values = std::vector<TestType> (size);
+          for (auto i = size_t{}; i < size; ++i)
+            {
+              values.at (i) = static_cast<TestType> (i % 100 + 1);
+            }
+          REQUIRE (simdFind (values.data (), size, TestType{}, level) == size);
+          for (auto position = size_t{}; position < size; ++position)
+            {
+              auto const &value = values.at (position);
+              REQUIRE (simdFind (values.data (), size, value, level) == simd::findScalar (values.data (), size, value));
+            }
+        }
+    }
+}
+
+TEST_CASE ("findIndex")
+{
+  SECTION ("integral")
+  {
+    auto const &values = std::vector<uint64_t>{ 5, 4, 3, 2, 1 };
+    REQUIRE (findIndex (std::span{ values }, uint64_t{ 1 }) == 4);
+    REQUIRE (findIndex (std::span{ values }, uint64_t{ 42 }) == 5);
+  }
+  SECTION ("not integral")
+  {
+    auto const &values = std::vector<std::string>{ "a", "b", "c" };
+    REQUIRE (findIndex (std::span{ values }, std::string{ "c" }) == 2);
+  }
+}
@@ -7,10 +7,13 @@ Distributed under the Boost Software License, Version 1.0.
 #include "small_memory_tree/smallMemoryTree.hxx"
 #include "small_memory_tree/stlplusTree.hxx"
 #include <algorithm>
+#include <array>
 #include <boost/numeric/conversion/cast.hpp>
 #include <catch2/catch.hpp>
 #include <expected>
 #include <iterator>
+#include <ranges>
+#include <span>
 #include <vector>
 
 using namespace small_memory_tree;
@@ -216,3 +219,49 @@ TEST_CASE ("smallSmallMemoryTree multiple elements")
     }
   }
 }
+
+TEST_CASE ("smallSmallMemoryTree calcChildrenSpanForPath and calcChildrenIndexForPath")
+{
+  stlplus::ntree<int> tree{};
+  auto root = tree.insert (0);
+  auto rootChild0 = tree.append (root, 1);
+  auto rootChild1 = tree.append (root, 2);
+  tree.append (rootChild0, 3);
+  tree.append (rootChild0, 4);
+  tree.append (rootChild1, 5);
+  auto myChild = tree.append (rootChild1, 6);
+  tree.append (myChild, 7);
+  auto smallMemoryTree = SmallMemoryTree<int>{ StlplusTreeAdapter{ tree } };
+  SECTION ("calcChildrenSpanForPath initializer_list")
+  {
+    auto result = calcChildrenSpanForPath (smallMemoryTree, { 0, 1 });
+    REQUIRE (result);
+    REQUIRE (std::ranges::equal (result.value (), std::vector<int>{ 3, 4 }));
+    REQUIRE (result->data () == smallMemoryTree.getValues ().data () + 3);
+  }
+  SECTION ("calcChildrenSpanForPath array")
+  {
+    auto const &path = std::array<int, 3>{ 0, 2, 6 };
+    REQUIRE (std::ranges::equal (calcChildrenSpanForPath (smallMemoryTree, path).value (), std::vector<int>{ 7 }));
+  }
+  SECTION ("calcChildrenSpanForPath span")
+  {
+    auto const &path = std::vector<int>{ 0, 2, 6, 7 };
+    REQUIRE (calcChildrenSpanForPath (smallMemoryTree, std::span{ path }).value ().empty ());
+  }
+  SECTION ("calcChildrenSpanForPath input range")
+  {
+    REQUIRE (std::ranges::equal (calcChildrenSpanForPath (smallMemoryTree, std::views::iota (0, 2)).value (), std::vector<int>{ 3, 4 }));
+  }
+  SECTION ("calcChildrenIndexForPath")
+  {
+    REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0 }).value () == std::tuple<uint64_t, uint64_t>{ 1, 3 });
+    REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0, 2 }, true).value () == std::tuple<uint64_t, uint64_t>{ 5, 7 });
+  }
+  SECTION ("wrong path")
+  {
+    REQUIRE (calcChildrenSpanForPath (smallMemoryTree, std::vector<int>{}).error () == ApiError::EmptyPath);
+    REQUIRE (calcChildrenSpanForPath (smallMemoryTree, { 0, 42 }).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0, 2, 6, 7, 42 }).error () == ApiError::PathTooLong);
+  }
+}
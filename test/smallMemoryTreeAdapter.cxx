@@ -4,8 +4,10 @@ Distributed under the Boost Software License, Version 1.0.
 (See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
  */
 
+#include "countAllocations.hxx"
 #include "small_memory_tree/stTree.hxx"
 #include "small_memory_tree/stlplusTree.hxx"
+#include <array>
 #include <boost/numeric/conversion/cast.hpp>
 #include <catch2/catch.hpp>
 #include <cstdint>
@@ -14,6 +16,44 @@ Distributed under the Boost Software License, Version 1.0.
 
 using namespace small_memory_tree;
 
+namespace
+{
+// tree from adapterCheck without a tree library
+struct BreadthFirstSource
+{
+  uint64_t
+  nodeCount () const
+  {
+    return 8;
+  }
+
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    auto const &childrenCounts = std::array<uint64_t, 8>{ 2, 2, 2, 0, 0, 0, 1, 0 };
+    for (auto i = uint64_t{}; i < childrenCounts.size (); ++i)
+      {
+        visitor (static_cast<int> (i), childrenCounts.at (i));
+      }
+  }
+};
+
+// node i has the child i + 1
+struct ChainSource
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = 0; i < 300; ++i)
+      {
+        visitor (i, uint64_t{ (i == 299) ? 0U : 1U });
+      }
+  }
+};
+}
+
 TEST_CASE ("adapterCheck")
 {
   stlplus::ntree<int> nTree{};
@@ -37,4 +77,52 @@ TEST_CASE ("adapterCheck")
   stTree.root ()[1][1].insert (7);
   auto smallMemoryTreeFromStTree = SmallMemoryTree<int>{ StTreeAdapter{ stTree } };
   REQUIRE (smallMemoryTreeFromStlplusNtree == smallMemoryTreeFromStTree);
-}
\ No newline at end of file
+}
+
+TEST_CASE ("IsBreadthFirstSource")
+{
+  auto const &expectedSmallMemoryTree = SmallMemoryTree<int>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint64_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+  SECTION ("same result as values and childrenOffsetEnds") { REQUIRE (SmallMemoryTree<int>{ BreadthFirstSource{} } == expectedSmallMemoryTree); }
+  SECTION ("tree which does not fit into ChildrenOffsetEndType")
+  {
+    // every node has at most one child but the childrenOffsetEnds of the chain go up to 299
+    REQUIRE_THROWS (SmallMemoryTree<int, uint8_t>{ ChainSource{} });
+    REQUIRE (SmallMemoryTree<int, uint16_t>{ ChainSource{} }.getChildrenOffsetEnds ().back () == 299);
+  }
+  SECTION ("allocates only values and childrenOffsetEnds")
+  {
+    auto const &allocationCountBefore = test::allocationCount ();
+    auto const &smallMemoryTree = SmallMemoryTree<int>{ BreadthFirstSource{} };
+    REQUIRE (test::allocationCount () - allocationCountBefore == 2);
+    REQUIRE (smallMemoryTree.getValues ().capacity () == 8);
+  }
+  SECTION ("same result as StTreeAdapter")
+  {
+    auto stTree = st_tree::tree<int>{};
+    stTree.insert (0);
+    stTree.root ().insert (1);
+    stTree.root ().insert (2);
+    stTree.root ()[0].insert (3);
+    stTree.root ()[0].insert (4);
+    stTree.root ()[1].insert (5);
+    stTree.root ()[1].insert (6);
+    stTree.root ()[1][1].insert (7);
+    REQUIRE (SmallMemoryTree<int>{ StTreeAdapter{ stTree } } == expectedSmallMemoryTree);
+  }
+}
+
+TEST_CASE ("adapters with all template parameters")
+{
+  auto stTree = st_tree::tree<int>{};
+  stTree.insert (0);
+  stTree.root ().insert (1);
+  stTree.root ().insert (2);
+  using StTreeNode = st_tree::detail::node_raw<st_tree::tree<int>, int>;
+  REQUIRE (SmallMemoryTree<int>{ StTreeAdapter<int, StTreeNode, st_tree::tree<int> >{ stTree } } == SmallMemoryTree<int>{ StTreeAdapter{ stTree } });
+  REQUIRE (StTreeNodeAdapter<int, StTreeNode>{ stTree.root () }.size () == 2);
+  stlplus::ntree<int> nTree{};
+  auto root = nTree.insert (0);
+  nTree.append (root, 1);
+  REQUIRE (SmallMemoryTree<int>{ StlplusTreeAdapter<int, stlplus::ntree_node<int>, stlplus::ntree<int> >{ nTree } } == SmallMemoryTree<int>{ StlplusTreeAdapter{ nTree } });
+  REQUIRE (StlplusNodeAdapter<int, stlplus::ntree_node<int> >{ *nTree.root ().node () }.data () == 0);
+}
@@ -0,0 +1,165 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "countAllocations.hxx"
+#include "small_memory_tree/smallMemoryTreeArena.hxx"
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <ranges>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+auto const smallMemoryTree = SmallMemoryTree<int>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint64_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+// root 10 has the child 11
+auto const otherSmallMemoryTree = SmallMemoryTree<int>{ std::vector<int>{ 10, 11 }, std::vector<uint64_t>{ 1, 1 } };
+
+struct ChainSource
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    visitor (20, uint64_t{ 1 });
+    visitor (21, uint64_t{ 1 });
+    visitor (22, uint64_t{ 0 });
+  }
+};
+
+// node i has the child i + 1
+struct ChainSource300
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    for (auto i = 0; i < 300; ++i)
+      {
+        visitor (i, uint64_t{ (i == 299) ? 0U : 1U });
+      }
+  }
+};
+
+// Throws while visiting the third node
+struct ThrowingSource
+{
+  template <typename Visitor>
+  void
+  visitBreadthFirst (Visitor &&visitor) const
+  {
+    visitor (30, uint64_t{ 1 });
+    visitor (31, uint64_t{ 1 });
+    visitor (32, uint64_t{ 300 });
+  }
+};
+}
+
+TEST_CASE ("SmallMemoryTreeArena")
+{
+  auto arena = SmallMemoryTreeArena<int, uint8_t>{};
+  auto const &handle = arena.add (smallMemoryTree);
+  auto const &otherHandle = arena.add (otherSmallMemoryTree);
+  auto const &chainHandle = arena.add (ChainSource{});
+  SECTION ("trees get stored one after another")
+  {
+    REQUIRE (arena.size () == 3);
+    REQUIRE (arena.nodeCount () == 13);
+    REQUIRE (handle == SmallMemoryTreeHandle{ 0 });
+    REQUIRE (chainHandle == SmallMemoryTreeHandle{ 2 });
+    REQUIRE (arena.getTree (otherHandle)->getValues ().data () == arena.getTree (handle)->getValues ().data () + 8);
+  }
+  SECTION ("getTree same as the added tree")
+  {
+    REQUIRE (std::ranges::equal (arena.getTree (handle)->getValues (), smallMemoryTree.getValues ()));
+    REQUIRE (std::ranges::equal (arena.getTree (handle)->getChildrenOffsetEnds (), smallMemoryTree.getChildrenOffsetEnds ()));
+    REQUIRE (std::ranges::equal (arena.getTree (otherHandle)->getChildrenOffsetEnds (), otherSmallMemoryTree.getChildrenOffsetEnds ()));
+    REQUIRE (std::ranges::equal (arena.getTree (chainHandle)->getValues (), std::vector<int>{ 20, 21, 22 }));
+    REQUIRE (arena.getTree (SmallMemoryTreeHandle{ 3 }).error () == ApiError::OutOfRange);
+  }
+  SECTION ("lookup functions work on the trees")
+  {
+    REQUIRE (calcChildrenForPath (arena.getTree (handle).value (), { 0, 2 }).value () == std::vector<int>{ 5, 6 });
+    REQUIRE (calcChildrenForPath (arena.getTree (otherHandle).value (), { 10 }).value () == std::vector<int>{ 11 });
+    REQUIRE (calcChildrenForPath (arena.getTree (chainHandle).value (), { 20, 21, 22 }).value ().empty ());
+    REQUIRE (calcChildrenForPath (arena.getTree (otherHandle).value (), { 0 }).error () == ApiError::PathDoesNotMatch);
+  }
+  SECTION ("trees")
+  {
+    auto rootValues = std::vector<int>{};
+    for (auto const &tree : arena.trees ())
+      {
+        rootValues.push_back (tree.getValues ().front ());
+      }
+    REQUIRE (rootValues == std::vector<int>{ 0, 10, 20 });
+  }
+  SECTION ("add does not change the arena if it throws")
+  {
+    REQUIRE_THROWS (arena.add (ThrowingSource{}));
+    REQUIRE (arena.size () == 3);
+    REQUIRE (arena.nodeCount () == 13);
+    REQUIRE (arena.add (otherSmallMemoryTree) == SmallMemoryTreeHandle{ 3 });
+    REQUIRE (std::ranges::equal (arena.getTree (SmallMemoryTreeHandle{ 3 })->getValues (), otherSmallMemoryTree.getValues ()));
+  }
+  SECTION ("tree which does not fit into ChildrenOffsetEndType")
+  {
+    // every node has at most one child but the childrenOffsetEnds of the chain go up to 299
+    REQUIRE_THROWS (arena.add (ChainSource300{}));
+    REQUIRE (arena.size () == 3);
+    auto wideArena = SmallMemoryTreeArena<int>{};
+    auto const &chainHandle300 = wideArena.add (ChainSource300{});
+    REQUIRE (wideArena.getTree (chainHandle300)->getChildrenOffsetEnds ().back () == 299);
+    REQUIRE (calcChildrenIndexForPath (wideArena.getTree (chainHandle300).value (), std::views::iota (0, 299)).value () == std::tuple<uint64_t, uint64_t>{ 299, 300 });
+  }
+  SECTION ("clear")
+  {
+    auto const &memoryUsage = arena.memoryUsage ();
+    arena.clear ();
+    REQUIRE (arena.empty ());
+    REQUIRE (arena.nodeCount () == 0);
+    REQUIRE (arena.memoryUsage () == memoryUsage);
+    REQUIRE (arena.add (otherSmallMemoryTree) == SmallMemoryTreeHandle{ 0 });
+  }
+}
+
+TEST_CASE ("SmallMemoryTreeArena bulk construction")
+{
+  auto const &smallMemoryTrees = std::vector<SmallMemoryTree<int> > (1000, smallMemoryTree);
+  auto const &allocationCountBefore = test::allocationCount ();
+  auto const &arena = SmallMemoryTreeArena<int, uint8_t>{ smallMemoryTrees };
+  // values and childrenOffsetEnds get allocated once. treeBegins twice because it starts with the end of the zeroth tree
+  REQUIRE (test::allocationCount () - allocationCountBefore == 4);
+  REQUIRE (arena.size () == 1000);
+  REQUIRE (arena.memoryUsage () == 8000 * sizeof (int) + 8000 * sizeof (uint8_t) + 1001 * sizeof (uint64_t));
+  REQUIRE (std::ranges::all_of (arena.trees (), [] (auto const &tree) { return calcChildrenIndexForPath (tree, { 0, 2, 6 }) == calcChildrenIndexForPath (smallMemoryTree, { 0, 2, 6 }); }));
+}
+
+TEST_CASE ("pmr")
+{
+  auto buffer = std::array<std::byte, 4096>{};
+  auto memoryResource = std::pmr::monotonic_buffer_resource{ buffer.data (), buffer.size (), std::pmr::null_memory_resource () };
+  SECTION ("SmallMemoryTree")
+  {
+    auto const &pmrSmallMemoryTree = pmr::SmallMemoryTree<int>{ ChainSource{}, &memoryResource };
+    REQUIRE (pmrSmallMemoryTree.get_allocator ().resource () == &memoryResource);
+    REQUIRE (calcChildrenForPath (pmrSmallMemoryTree, { 20, 21 }).value () == std::vector<int>{ 22 });
+    REQUIRE (SmallMemoryTreeView<int>{ pmrSmallMemoryTree }.getValues ().data () == pmrSmallMemoryTree.getValues ().data ());
+  }
+  SECTION ("SmallMemoryTreeArena")
+  {
+    auto arena = pmr::SmallMemoryTreeArena<int>{ &memoryResource };
+    auto const &allocationCountBefore = test::allocationCount ();
+    arena.add (smallMemoryTree);
+    arena.add (otherSmallMemoryTree);
+    REQUIRE (test::allocationCount () == allocationCountBefore);
+    REQUIRE (calcChildrenForPath (arena.getTree (SmallMemoryTreeHandle{ 1 }).value (), { 10 }).value () == std::vector<int>{ 11 });
+  }
+}
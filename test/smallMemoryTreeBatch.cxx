@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/smallMemoryTreeBatch.hxx"
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// Random tree with nodeCount nodes. Every node has up to 3 children with values from 0 to 3 so many paths share a prefix and some children have the same value
+SmallMemoryTree<int>
+randomTree (uint64_t nodeCount, std::mt19937_64 &randomNumberGenerator)
+{
+  auto childrenCounts = std::vector<uint64_t>{};
+  auto createdNodeCount = uint64_t{ 1 };
+  for (auto node = uint64_t{}; node < createdNodeCount; ++node)
+    {
+      auto const childrenCount = std::min (std::uniform_int_distribution<uint64_t>{ 0, 3 }(randomNumberGenerator), nodeCount - createdNodeCount);
+      childrenCounts.push_back (childrenCount);
+      createdNodeCount += childrenCount;
+    }
+  auto values = std::vector<int> (childrenCounts.size ());
+  std::ranges::generate (values | std::views::drop (1), [&randomNumberGenerator] () { return std::uniform_int_distribution<int>{ 0, 3 }(randomNumberGenerator); });
+  auto childrenOffsetEnds = std::vector<uint64_t> (childrenCounts.size ());
+  std::partial_sum (childrenCounts.begin (), childrenCounts.end (), childrenOffsetEnds.begin ());
+  return SmallMemoryTree<int>{ std::move (values), std::move (childrenOffsetEnds) };
+}
+
+std::vector<std::vector<int> >
+randomPaths (uint64_t pathCount, std::mt19937_64 &randomNumberGenerator)
+{
+  auto paths = std::vector<std::vector<int> > (pathCount);
+  for (auto &path : paths)
+    {
+      path.resize (std::uniform_int_distribution<uint64_t>{ 0, 8 }(randomNumberGenerator));
+      std::ranges::generate (path, [&randomNumberGenerator] () { return std::uniform_int_distribution<int>{ 0, 3 }(randomNumberGenerator); });
+      if (not path.empty () and std::uniform_int_distribution<int>{ 0, 9 }(randomNumberGenerator) != 0) path.front () = 0; // mostly start at the root
+    }
+  return paths;
+}
+}
+
+TEST_CASE ("calcChildrenIndexForPaths same result as calcChildrenIndexForPath")
+{
+  auto randomNumberGenerator = std::mt19937_64{ 42 };
+  for (auto const &nodeCount : { uint64_t{ 1 }, uint64_t{ 2 }, uint64_t{ 50 }, uint64_t{ 5000 } })
+    {
+      auto const &smallMemoryTree = randomTree (nodeCount, randomNumberGenerator);
+      auto const &paths = randomPaths (2000, randomNumberGenerator);
+      for (auto const &threadCount : { uint64_t{ 1 }, uint64_t{ 3 } })
+        {
+          INFO ("nodeCount " << nodeCount << " threadCount " << threadCount);
+          auto const &results = calcChildrenIndexForPaths (smallMemoryTree, paths, false, threadCount);
+          REQUIRE (results.size () == paths.size ());
+          for (auto i = uint64_t{}; i < paths.size (); ++i)
+            {
+              REQUIRE (results.at (i) == calcChildrenIndexForPath (smallMemoryTree, paths.at (i)));
+            }
+        }
+    }
+}
+
+TEST_CASE ("calcChildrenForPaths")
+{
+  // root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+  auto const &smallMemoryTree = SmallMemoryTree<int, uint8_t>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+  auto const &paths = std::vector<std::vector<int> >{ { 0, 2, 6 }, {}, { 0, 1 }, { 0, 2, 6, 7, 1 }, { 0, 2, 9 }, { 1 }, { 0, 2 }, { 0, 1 } };
+  SECTION ("results are in the order of paths")
+  {
+    using ChildrenExpected = std::expected<std::vector<int>, std::error_condition>;
+    auto const &expectedResults = std::vector<ChildrenExpected>{ std::vector<int>{ 7 }, std::unexpected (make_error_condition (ApiError::EmptyPath)), std::vector<int>{ 3, 4 }, std::unexpected (make_error_condition (ApiError::PathTooLong)), std::unexpected (make_error_condition (ApiError::PathDoesNotMatch)), std::unexpected (make_error_condition (ApiError::PathDoesNotMatch)), std::vector<int>{ 5, 6 }, std::vector<int>{ 3, 4 } };
+    REQUIRE (calcChildrenForPaths (smallMemoryTree, paths) == expectedResults);
+    REQUIRE (calcChildrenForPaths (smallMemoryTree, paths, true, 4) == expectedResults);
+    REQUIRE (calcChildrenForPaths (smallMemoryTree, paths, EytzingerIndex<int>{ smallMemoryTree, 1 }) == expectedResults);
+  }
+  SECTION ("spans point into the tree")
+  {
+    auto const &childrenSpans = calcChildrenSpanForPaths (smallMemoryTree, paths);
+    REQUIRE (childrenSpans.at (6).value ().data () == smallMemoryTree.getValues ().data () + 5);
+  }
+  SECTION ("any random access range of paths")
+  {
+    auto const &arrayPaths = std::array<std::array<int, 2>, 3>{ { { 0, 2 }, { 0, 1 }, { 0, 3 } } };
+    REQUIRE (calcChildrenIndexForPaths (smallMemoryTree, arrayPaths) == std::vector<std::expected<std::tuple<uint64_t, uint64_t>, std::error_condition> >{ std::tuple<uint64_t, uint64_t>{ 5, 7 }, std::tuple<uint64_t, uint64_t>{ 3, 5 }, std::unexpected (make_error_condition (ApiError::PathDoesNotMatch)) });
+  }
+  SECTION ("no paths")
+  {
+    REQUIRE (calcChildrenForPaths (smallMemoryTree, std::vector<std::vector<int> >{}, false, 4).empty ());
+  }
+  SECTION ("empty tree")
+  {
+    REQUIRE (calcChildrenForPaths (SmallMemoryTree<int>{}, paths).at (0).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (calcChildrenForPaths (SmallMemoryTree<int>{}, paths).at (1).error () == ApiError::EmptyPath);
+  }
+}
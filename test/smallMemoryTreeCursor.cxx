@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "countAllocations.hxx"
+#include "small_memory_tree/smallMemoryTreeCursor.hxx"
+#include "small_memory_tree/succinctSmallMemoryTree.hxx"
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+auto const smallMemoryTree = SmallMemoryTree<int, uint8_t>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+
+template <std::ranges::range Range>
+std::vector<int>
+valuesOf (Range &&cursors)
+{
+  auto result = std::vector<int>{};
+  std::ranges::transform (cursors, std::back_inserter (result), [] (auto const &cursor) { return cursor.getValue (); });
+  return result;
+}
+}
+
+static_assert (std::ranges::forward_range<decltype (Cursor{ smallMemoryTree }.breadthFirst ())>);
+static_assert (std::ranges::forward_range<decltype (Cursor{ smallMemoryTree }.depthFirst ())>);
+
+TEST_CASE ("Cursor")
+{
+  auto const &root = Cursor{ smallMemoryTree };
+  SECTION ("child")
+  {
+    auto const &cursor = root.child (2);
+    REQUIRE (cursor);
+    REQUIRE (cursor->getIndex () == 2);
+    REQUIRE (std::ranges::equal (cursor->children ().value (), std::vector<int>{ 5, 6 }));
+    REQUIRE (cursor->child (6)->child (7)->children ().value ().empty ());
+    REQUIRE (cursor->child (6)->child (7)->child (8).error () == ApiError::PathTooLong);
+    REQUIRE (cursor->child (42).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (cursor->child (6, true) == cursor->child (6));
+  }
+  SECTION ("descendant same as calcChildrenForPath")
+  {
+    REQUIRE (std::ranges::equal (root.descendant (std::array{ 2, 6 })->children ().value (), calcChildrenSpanForPath (smallMemoryTree, { 0, 2, 6 }).value ()));
+    REQUIRE (root.descendant (std::array{ 2, 3 }).error () == ApiError::PathDoesNotMatch);
+  }
+  SECTION ("parent")
+  {
+    auto const &expectedParents = std::array<int, 8>{ -1, 0, 0, 1, 1, 2, 2, 6 };
+    for (auto index = uint64_t{ 1 }; index < expectedParents.size (); ++index)
+      {
+        REQUIRE (Cursor{ smallMemoryTree, index }.parent ()->getValue () == expectedParents.at (index));
+      }
+    REQUIRE (root.parent ().error () == ApiError::RootHasNoParent);
+    REQUIRE (Cursor{ smallMemoryTree, 8 }.parent ().error () == ApiError::OutOfRange);
+  }
+  SECTION ("childCursors") { REQUIRE (valuesOf (root.child (1)->childCursors ()) == std::vector<int>{ 3, 4 }); }
+  SECTION ("breadthFirst")
+  {
+    REQUIRE (valuesOf (root.breadthFirst ()) == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+    REQUIRE (valuesOf (root.child (2)->breadthFirst ()) == std::vector<int>{ 2, 5, 6, 7 });
+    REQUIRE (valuesOf (root.child (1)->child (4)->breadthFirst ()) == std::vector<int>{ 4 });
+  }
+  SECTION ("depthFirst")
+  {
+    REQUIRE (valuesOf (root.depthFirst ()) == std::vector<int>{ 0, 1, 3, 4, 2, 5, 6, 7 });
+    REQUIRE (valuesOf (root.child (1)->depthFirst ()) == std::vector<int>{ 1, 3, 4 });
+    REQUIRE (valuesOf (root.child (2)->depthFirst () | std::views::take (2)) == std::vector<int>{ 2, 5 });
+  }
+  SECTION ("does not allocate")
+  {
+    auto const &allocationCountBefore = test::allocationCount ();
+    auto sum = int{};
+    for (auto const &cursor : root.depthFirst ())
+      {
+        sum += cursor.getValue () + cursor.parent ().value_or (root).getValue ();
+      }
+    for (auto const &cursor : root.breadthFirst ())
+      {
+        sum += cursor.getValue ();
+      }
+    REQUIRE (test::allocationCount () - allocationCountBefore == 0);
+    REQUIRE (sum == 2 * 28 + 0 + 0 + 1 + 1 + 2 + 2 + 6);
+  }
+}
+
+TEST_CASE ("Cursor on SuccinctSmallMemoryTree")
+{
+  auto const &succinctSmallMemoryTree = SuccinctSmallMemoryTree<int>{ smallMemoryTree };
+  auto const &root = Cursor{ succinctSmallMemoryTree };
+  REQUIRE (root.child (2)->child (6)->child (7)->parent ()->parent ()->getValue () == 2);
+  REQUIRE (valuesOf (root.depthFirst ()) == std::vector<int>{ 0, 1, 3, 4, 2, 5, 6, 7 });
+}
@@ -0,0 +1,266 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTreeEdit.hxx"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// Random tree with nodeCount nodes. Every node has up to 3 children with values from 0 to 3 so some children have the same value
+SmallMemoryTree<int>
+randomTree (uint64_t nodeCount, std::mt19937_64 &randomNumberGenerator)
+{
+  if (nodeCount == 0) return {};
+  auto childrenCounts = std::vector<uint64_t>{};
+  auto createdNodeCount = uint64_t{ 1 };
+  for (auto node = uint64_t{}; node < createdNodeCount; ++node)
+    {
+      auto const childrenCount = std::min (std::uniform_int_distribution<uint64_t>{ 0, 3 }(randomNumberGenerator), nodeCount - createdNodeCount);
+      childrenCounts.push_back (childrenCount);
+      createdNodeCount += childrenCount;
+    }
+  auto values = std::vector<int> (childrenCounts.size ());
+  std::ranges::generate (values, [&randomNumberGenerator] () { return std::uniform_int_distribution<int>{ 0, 3 }(randomNumberGenerator); });
+  auto childrenOffsetEnds = std::vector<uint64_t> (childrenCounts.size ());
+  std::partial_sum (childrenCounts.begin (), childrenCounts.end (), childrenOffsetEnds.begin ());
+  return SmallMemoryTree<int>{ std::move (values), std::move (childrenOffsetEnds) };
+}
+
+// Path from the root to nodeIndex
+std::vector<int>
+pathToNode (SmallMemoryTree<int> const &smallMemoryTree, uint64_t nodeIndex)
+{
+  auto path = std::vector<int>{ smallMemoryTree.getValues ().at (nodeIndex) };
+  while (nodeIndex != 0)
+    {
+      nodeIndex = internals::parentIndex (smallMemoryTree, nodeIndex).value ();
+      path.push_back (smallMemoryTree.getValues ().at (nodeIndex));
+    }
+  std::ranges::reverse (path);
+  return path;
+}
+
+// Pointer tree to apply edits the obvious way
+struct Node
+{
+  int value{};
+  std::vector<Node> children{};
+};
+
+Node
+toNode (SmallMemoryTree<int> const &smallMemoryTree, uint64_t nodeIndex = 0)
+{
+  auto node = Node{ smallMemoryTree.getValues ().at (nodeIndex), {} };
+  auto const [childrenBeginIndex, childrenEndIndex] = internals::childrenBeginAndEndIndex (smallMemoryTree, nodeIndex).value ();
+  for (auto childIndex = childrenBeginIndex; childIndex < childrenEndIndex; ++childIndex)
+    {
+      node.children.push_back (toNode (smallMemoryTree, childIndex));
+    }
+  return node;
+}
+
+SmallMemoryTree<int>
+toSmallMemoryTree (Node const &root)
+{
+  auto values = std::vector<int>{};
+  auto childrenOffsetEnds = std::vector<uint64_t>{};
+  auto nodes = std::deque<Node const *>{ &root };
+  while (not nodes.empty ())
+    {
+      auto const *node = nodes.front ();
+      nodes.pop_front ();
+      values.push_back (node->value);
+      childrenOffsetEnds.push_back ((childrenOffsetEnds.empty () ? 0 : childrenOffsetEnds.back ()) + node->children.size ());
+      for (auto const &child : node->children)
+        {
+          nodes.push_back (&child);
+        }
+    }
+  return SmallMemoryTree<int>{ std::move (values), std::move (childrenOffsetEnds) };
+}
+
+// The first child with the value of the path like calcChildrenForPath
+std::expected<Node const *, std::error_condition>
+findNode (Node const &root, std::vector<int> const &path)
+{
+  if (path.empty ()) return std::unexpected (make_error_condition (ApiError::EmptyPath));
+  if (root.value != path.front ()) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+  auto const *node = &root;
+  for (auto const &value : path | std::views::drop (1))
+    {
+      if (node->children.empty ()) return std::unexpected (make_error_condition (ApiError::PathTooLong));
+      auto const &child = std::ranges::find (node->children, value, &Node::value);
+      if (child == node->children.end ()) return std::unexpected (make_error_condition (ApiError::PathDoesNotMatch));
+      node = &*child;
+    }
+  return node;
+}
+
+bool
+isInside (Node const &node, Node const *searched)
+{
+  return &node == searched or std::ranges::any_of (node.children, [searched] (Node const &child) { return isInside (child, searched); });
+}
+
+// Applies the edits to a copy of the pointer tree. Same result as applyEdits
+std::expected<SmallMemoryTree<int>, std::error_condition>
+applyEditsToNode (Node const &root, std::vector<Edit<int> > const &edits)
+{
+  auto replacedValues = std::map<Node const *, int>{};
+  auto removedNodes = std::set<Node const *>{};
+  auto insertedSubtrees = std::map<Node const *, std::vector<InsertSubtree<int> const *> >{};
+  auto changedTwice = false; // path errors get reported first
+  for (auto const &edit : edits)
+    {
+      auto const &nodeExpected = std::visit ([&root] (auto const &concreteEdit) { return findNode (root, concreteEdit.path); }, edit);
+      if (not nodeExpected) return std::unexpected (nodeExpected.error ());
+      auto const *node = nodeExpected.value ();
+      if (auto const *replaceValue = std::get_if<ReplaceValue<int> > (&edit))
+        {
+          changedTwice = changedTwice or not replacedValues.emplace (node, replaceValue->value).second;
+        }
+      else if (std::holds_alternative<RemoveSubtree<int> > (edit))
+        {
+          changedTwice = changedTwice or not removedNodes.insert (node).second;
+        }
+      else if (not std::get<InsertSubtree<int> > (edit).subtree.getValues ().empty ())
+        {
+          insertedSubtrees[node].push_back (&std::get<InsertSubtree<int> > (edit));
+        }
+    }
+  if (changedTwice) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+  // every edit of a node inside a removed subtree conflicts
+  for (auto const *removedNode : removedNodes)
+    {
+      auto const &isInsideRemovedNode = [removedNode] (Node const *node) { return isInside (*removedNode, node); };
+      if (std::ranges::any_of (removedNodes, [&] (Node const *node) { return node != removedNode and isInsideRemovedNode (node); }) or std::ranges::any_of (replacedValues | std::views::keys, isInsideRemovedNode) or std::ranges::any_of (insertedSubtrees | std::views::keys, isInsideRemovedNode)) return std::unexpected (make_error_condition (ApiError::ConflictingEdits));
+    }
+  if (removedNodes.contains (&root)) return SmallMemoryTree<int>{};
+  for (auto &[node, subtrees] : insertedSubtrees)
+    {
+      std::ranges::stable_sort (subtrees, {}, &InsertSubtree<int>::position);
+    }
+  auto const &copy = [&] (auto const &self, Node const &node) -> Node {
+    auto result = Node{ replacedValues.contains (&node) ? replacedValues.at (&node) : node.value, {} };
+    auto const &subtrees = insertedSubtrees.contains (&node) ? insertedSubtrees.at (&node) : std::vector<InsertSubtree<int> const *>{};
+    auto subtree = subtrees.begin ();
+    for (auto position = uint64_t{}; position <= node.children.size (); ++position)
+      {
+        for (; subtree != subtrees.end () and (position == node.children.size () or (*subtree)->position <= position); ++subtree)
+          {
+            result.children.push_back (toNode ((*subtree)->subtree));
+          }
+        if (position != node.children.size () and not removedNodes.contains (&node.children.at (position))) result.children.push_back (self (self, node.children.at (position)));
+      }
+    return result;
+  };
+  return toSmallMemoryTree (copy (copy, root));
+}
+}
+
+TEST_CASE ("applyEdits")
+{
+  // root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+  auto const &smallMemoryTree = SmallMemoryTree<int, uint8_t>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+  auto const &subtree = SmallMemoryTree<int>{ std::vector<int>{ 8, 9 }, std::vector<uint64_t>{ 1, 1 } };
+  SECTION ("no edits")
+  {
+    REQUIRE (applyEdits (smallMemoryTree, std::vector<Edit<int> >{}).value () == smallMemoryTree);
+  }
+  SECTION ("replace value")
+  {
+    auto const editedTree = applyEdits (smallMemoryTree, { ReplaceValue<int>{ { 0, 2, 6 }, 10 }, ReplaceValue<int>{ { 0 }, 11 } }).value ();
+    REQUIRE (editedTree.getValues () == std::vector<int>{ 11, 1, 2, 3, 4, 5, 10, 7 });
+    REQUIRE (editedTree.getChildrenOffsetEnds () == smallMemoryTree.getChildrenOffsetEnds ());
+    REQUIRE (smallMemoryTree.getValues ().at (6) == 6);
+  }
+  SECTION ("remove subtree")
+  {
+    auto const editedTree = applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 2 } }, RemoveSubtree<int>{ { 0, 1, 3 } } }).value ();
+    REQUIRE (editedTree.getValues () == std::vector<int>{ 0, 1, 4 });
+    REQUIRE (editedTree.getChildrenOffsetEnds () == std::vector<uint8_t>{ 1, 2, 2 });
+  }
+  SECTION ("remove root")
+  {
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0 } } }).value ().getValues ().empty ());
+  }
+  SECTION ("insert subtree")
+  {
+    auto const editedTree = applyEdits (smallMemoryTree, { InsertSubtree<int>{ { 0, 2 }, subtree, 1 }, InsertSubtree<int>{ { 0, 1, 4 }, subtree } }).value ();
+    REQUIRE (editedTree.getValues () == std::vector<int>{ 0, 1, 2, 3, 4, 5, 8, 6, 8, 9, 7, 9 });
+    REQUIRE (editedTree.getChildrenOffsetEnds () == std::vector<uint8_t>{ 2, 4, 7, 7, 8, 8, 9, 10, 11, 11, 11, 11 });
+  }
+  SECTION ("insert subtree in front of removed subtree")
+  {
+    auto const editedTree = applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 1 } }, InsertSubtree<int>{ { 0 }, subtree, 0 } }).value ();
+    REQUIRE (editedTree.getValues () == std::vector<int>{ 0, 8, 2, 9, 5, 6, 7 });
+    REQUIRE (editedTree.getChildrenOffsetEnds () == std::vector<uint8_t>{ 2, 3, 5, 5, 5, 6, 6 });
+  }
+  SECTION ("inserted subtree does not fit into ChildrenOffsetEndType")
+  {
+    auto const &wideSubtree = SmallMemoryTree<int>{ std::vector<int> (300), std::vector<uint64_t> (300, 299) };
+    REQUIRE (applyEdits (smallMemoryTree, { InsertSubtree<int>{ { 0 }, wideSubtree } }).error () == ApiError::OutOfRange);
+  }
+  SECTION ("conflicting edits")
+  {
+    REQUIRE (applyEdits (smallMemoryTree, { ReplaceValue<int>{ { 0, 1 }, 10 }, ReplaceValue<int>{ { 0, 1 }, 11 } }).error () == ApiError::ConflictingEdits);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 2 } }, RemoveSubtree<int>{ { 0, 2 } } }).error () == ApiError::ConflictingEdits);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 2 } }, RemoveSubtree<int>{ { 0, 2, 6 } } }).error () == ApiError::ConflictingEdits);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 2 } }, ReplaceValue<int>{ { 0, 2, 6, 7 }, 10 } }).error () == ApiError::ConflictingEdits);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 2 } }, InsertSubtree<int>{ { 0, 2 }, subtree } }).error () == ApiError::ConflictingEdits);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0 } }, ReplaceValue<int>{ { 0 }, 10 } }).error () == ApiError::ConflictingEdits);
+  }
+  SECTION ("path errors")
+  {
+    REQUIRE (applyEdits (smallMemoryTree, { ReplaceValue<int>{ {}, 10 } }).error () == ApiError::EmptyPath);
+    REQUIRE (applyEdits (smallMemoryTree, { RemoveSubtree<int>{ { 0, 3 } } }).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (applyEdits (smallMemoryTree, { InsertSubtree<int>{ { 0, 1, 3, 0 }, subtree } }).error () == ApiError::PathTooLong);
+    REQUIRE (applyEdits (SmallMemoryTree<int>{}, { ReplaceValue<int>{ { 0 }, 10 } }).error () == ApiError::PathDoesNotMatch);
+  }
+}
+
+TEST_CASE ("applyEdits same result as editing a pointer tree")
+{
+  auto randomNumberGenerator = std::mt19937_64{ 42 };
+  for (auto iteration = 0; iteration < 500; ++iteration)
+    {
+      auto const &smallMemoryTree = randomTree (std::uniform_int_distribution<uint64_t>{ 1, 40 }(randomNumberGenerator), randomNumberGenerator);
+      auto const &nodeCount = smallMemoryTree.getValues ().size ();
+      auto const &randomPath = [&] () {
+        auto path = pathToNode (smallMemoryTree, std::uniform_int_distribution<uint64_t>{ 0, nodeCount - 1 }(randomNumberGenerator));
+        if (std::uniform_int_distribution<int>{ 0, 19 }(randomNumberGenerator) == 0) path.push_back (9);
+        return path;
+      };
+      auto edits = std::vector<Edit<int> >{};
+      for (auto editCount = std::uniform_int_distribution<int>{ 0, 4 }(randomNumberGenerator); editCount != 0; --editCount)
+        {
+          switch (std::uniform_int_distribution<int>{ 0, 2 }(randomNumberGenerator))
+            {
+            case 0:
+              edits.push_back (ReplaceValue<int>{ randomPath (), 10 + editCount });
+              break;
+            case 1:
+              edits.push_back (RemoveSubtree<int>{ randomPath () });
+              break;
+            default:
+              edits.push_back (InsertSubtree<int>{ randomPath (), randomTree (std::uniform_int_distribution<uint64_t>{ 0, 5 }(randomNumberGenerator), randomNumberGenerator), std::uniform_int_distribution<uint64_t>{ 0, 4 }(randomNumberGenerator) });
+            }
+        }
+      INFO ("iteration " << iteration);
+      REQUIRE (applyEdits (smallMemoryTree, edits) == applyEditsToNode (toNode (smallMemoryTree), edits));
+    }
+}
@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/smallMemoryTreeFile.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+using namespace small_memory_tree;
+
+TEST_CASE ("SmallMemoryTreeView")
+{
+  auto const &values = std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 };
+  auto const &childrenOffsetEnds = std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 };
+  auto smallMemoryTree = SmallMemoryTree<int, uint8_t>{ values, childrenOffsetEnds };
+  auto smallMemoryTreeView = SmallMemoryTreeView<int, uint8_t>{ values, childrenOffsetEnds };
+  SECTION ("calcChildrenForPath same result as SmallMemoryTree")
+  {
+    REQUIRE (calcChildrenForPath (smallMemoryTreeView, { 0 }).value () == std::vector<int>{ 1, 2 });
+    REQUIRE (calcChildrenForPath (smallMemoryTreeView, { 0, 2, 6 }).value () == calcChildrenForPath (smallMemoryTree, { 0, 2, 6 }).value ());
+    REQUIRE (calcChildrenForPath (smallMemoryTreeView, { 0, 2, 6, 7, 42 }).error () == ApiError::PathTooLong);
+  }
+  SECTION ("view from SmallMemoryTree")
+  {
+    auto viewFromTree = SmallMemoryTreeView{ smallMemoryTree };
+    REQUIRE (internals::childrenBeginAndEndIndex (viewFromTree, 6).value () == internals::childrenBeginAndEndIndex (smallMemoryTree, 6).value ());
+    REQUIRE (internals::getChildrenCount (viewFromTree, 8).error () == ApiError::OutOfRange);
+  }
+  SECTION ("childrenOffsetEnds pointing outside of values")
+  {
+    auto const &brokenChildrenOffsetEnds = std::vector<uint8_t>{ 2, 42 };
+    auto const &brokenView = SmallMemoryTreeView<int, uint8_t>{ std::span{ values }.first (2), brokenChildrenOffsetEnds };
+    REQUIRE (internals::childrenBeginAndEndIndex (brokenView, 1).error () == ApiError::OutOfRange);
+  }
+}
+
+TEST_CASE ("binary file format")
+{
+  auto smallMemoryTree = SmallMemoryTree<uint16_t, uint8_t>{ std::vector<uint16_t>{ 0, 1, 2, 3, 4 }, std::vector<uint8_t>{ 2, 3, 3, 4, 4 } };
+  auto const &bytes = serialize (smallMemoryTree);
+  SECTION ("viewFromBytes")
+  {
+    auto viewExpected = viewFromBytes<uint16_t, uint8_t> (bytes);
+    REQUIRE (viewExpected);
+    REQUIRE (std::ranges::equal (viewExpected->getValues (), smallMemoryTree.getValues ()));
+    REQUIRE (std::ranges::equal (viewExpected->getChildrenOffsetEnds (), smallMemoryTree.getChildrenOffsetEnds ()));
+    REQUIRE (calcChildrenForPath (viewExpected.value (), { 0, 1, 3 }).value () == std::vector<uint16_t>{ 4 });
+  }
+  SECTION ("sections are aligned")
+  {
+    auto const &header = *reinterpret_cast<internals::FileHeader const *> (bytes.data ());
+    REQUIRE (header.valuesOffset % internals::fileSectionAlignment == 0);
+    REQUIRE (header.childrenOffsetEndsOffset % internals::fileSectionAlignment == 0);
+  }
+  SECTION ("wrong type") { REQUIRE (viewFromBytes<uint32_t, uint8_t> (bytes).error () == ApiError::TypeMismatch); }
+  SECTION ("wrong children offset end type") { REQUIRE (viewFromBytes<uint16_t, uint64_t> (bytes).error () == ApiError::TypeMismatch); }
+  SECTION ("wrong magic")
+  {
+    auto brokenBytes = bytes;
+    brokenBytes.at (0) = std::byte{ 'X' };
+    REQUIRE (viewFromBytes<uint16_t, uint8_t> (brokenBytes).error () == ApiError::InvalidFileFormat);
+  }
+  SECTION ("other byte order")
+  {
+    auto brokenBytes = bytes;
+    std::swap (brokenBytes.at (offsetof (internals::FileHeader, byteOrderMark)), brokenBytes.at (offsetof (internals::FileHeader, byteOrderMark) + 1));
+    REQUIRE (viewFromBytes<uint16_t, uint8_t> (brokenBytes).error () == ApiError::ByteOrderMismatch);
+  }
+  SECTION ("newer version")
+  {
+    auto brokenBytes = bytes;
+    auto const &version = uint16_t{ internals::fileFormatVersion + 1 };
+    std::memcpy (brokenBytes.data () + offsetof (internals::FileHeader, version), &version, sizeof (version));
+    REQUIRE (viewFromBytes<uint16_t, uint8_t> (brokenBytes).error () == ApiError::UnsupportedFileVersion);
+  }
+  SECTION ("truncated")
+  {
+    auto brokenBytes = bytes;
+    brokenBytes.pop_back ();
+    REQUIRE (viewFromBytes<uint16_t, uint8_t> (brokenBytes).error () == ApiError::InvalidFileFormat);
+  }
+  SECTION ("save to file and memory map")
+  {
+    auto const &path = std::filesystem::temp_directory_path () / "small_memory_tree_file_test.smt";
+    REQUIRE (saveToFile (smallMemoryTree, path));
+    {
+      auto mappedSmallMemoryTreeExpected = MappedSmallMemoryTree<uint16_t, uint8_t>::open (path);
+      REQUIRE (mappedSmallMemoryTreeExpected);
+      REQUIRE (calcChildrenForPath (mappedSmallMemoryTreeExpected.value (), { 0 }).value () == std::vector<uint16_t>{ 1, 2 });
+      REQUIRE (calcChildrenForPath (mappedSmallMemoryTreeExpected->getView (), { 0, 1 }).value () == std::vector<uint16_t>{ 3 });
+    }
+    std::filesystem::remove (path);
+  }
+  SECTION ("open missing file") { REQUIRE_FALSE (MappedSmallMemoryTree<uint16_t, uint8_t>::open (std::filesystem::temp_directory_path () / "small_memory_tree_file_test_does_not_exist.smt")); }
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/fixedSmallMemoryTree.hxx"
+#include "small_memory_tree/smallMemoryTreeCursor.hxx"
+#include "small_memory_tree/smallMemoryTreeStatistics.hxx"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+using namespace small_memory_tree;
+
+namespace
+{
+// root 0 has the children 1 and 2. 1 has the children 3 and 4, 2 has 5 and 6 and 6 has 7
+auto const smallMemoryTree = SmallMemoryTree<int>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint64_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+
+// Keeps every LevelStatistics
+struct LevelRecorder
+{
+  std::vector<LevelStatistics> levels{};
+
+  void
+  recordLevel (uint64_t, LevelStatistics const &levelStatistics)
+  {
+    levels.push_back (levelStatistics);
+  }
+};
+}
+
+TEST_CASE ("InstrumentedChildSearch")
+{
+  auto lookupStatistics = LookupStatistics{};
+  SECTION ("linear search counts comparisons")
+  {
+    auto const &childSearch = InstrumentedChildSearch{ lookupStatistics };
+    REQUIRE (calcChildrenForPath (smallMemoryTree, { 0, 2, 6 }, childSearch).value () == std::vector<int>{ 7 });
+    // 0 is found with 1 comparison, 2 with 2 and 6 with 2
+    REQUIRE (lookupStatistics == LookupStatistics{ .lookups = 1, .levels = 3, .comparisons = 5, .bytesScanned = 5 * sizeof (int) });
+    REQUIRE (calcChildrenForPath (smallMemoryTree, { 0, 9 }, childSearch).error () == ApiError::PathDoesNotMatch);
+    REQUIRE (lookupStatistics == LookupStatistics{ .lookups = 2, .levels = 5, .comparisons = 8, .bytesScanned = 8 * sizeof (int) });
+  }
+  SECTION ("same result as the wrapped child search")
+  {
+    auto const &eytzingerIndex = EytzingerIndex<int>{ smallMemoryTree, 1 };
+    auto const &childSearch = InstrumentedChildSearch<EytzingerIndex<int> >{ lookupStatistics, eytzingerIndex };
+    for (auto const &path : std::vector<std::vector<int> >{ { 0 }, { 0, 1 }, { 0, 2, 6 }, { 0, 2, 6, 7 }, { 0, 3 }, { 1 } })
+      {
+        REQUIRE (calcChildrenIndexForPath (smallMemoryTree, path, childSearch) == calcChildrenIndexForPath (smallMemoryTree, path, eytzingerIndex));
+      }
+    REQUIRE (lookupStatistics.lookups == 6);
+    REQUIRE (InstrumentedChildSearch{ lookupStatistics, true }.findChild (std::span<int const>{ smallMemoryTree.getValues () }, 1, 3, 2) == 2);
+  }
+  SECTION ("lookups through the cursor and nodeIndexForPath")
+  {
+    auto const &childSearch = InstrumentedChildSearch{ lookupStatistics };
+    REQUIRE (Cursor{ smallMemoryTree }.child (2, childSearch)->getIndex () == 2);
+    REQUIRE (internals::nodeIndexForPath (smallMemoryTree, std::vector<int>{ 0, 2 }, childSearch).value () == 2);
+    REQUIRE (lookupStatistics.levels == 3);
+    REQUIRE (lookupStatistics.lookups == 1);
+  }
+  SECTION ("custom recorder")
+  {
+    auto levelRecorder = LevelRecorder{};
+    REQUIRE (calcChildrenIndexForPath (smallMemoryTree, { 0, 2, 5 }, InstrumentedChildSearch{ levelRecorder }));
+    REQUIRE (levelRecorder.levels.size () == 3);
+    REQUIRE (levelRecorder.levels.at (1).childrenCount == 2);
+    REQUIRE (levelRecorder.levels.at (2).comparisons == 1);
+  }
+  SECTION ("NoLookupStatistics")
+  {
+    auto noLookupStatistics = NoLookupStatistics{};
+    REQUIRE (calcChildrenForPath (smallMemoryTree, { 0, 2 }, InstrumentedChildSearch{ noLookupStatistics }).value () == std::vector<int>{ 5, 6 });
+  }
+}
+
+TEST_CASE ("analyze")
+{
+  SECTION ("SmallMemoryTree")
+  {
+    auto const treeAnalysis = analyze (smallMemoryTree).value ();
+    REQUIRE (treeAnalysis.nodeCount == 8);
+    REQUIRE (treeAnalysis.depth == 4);
+    REQUIRE (treeAnalysis.nodeCountPerLevel == std::vector<uint64_t>{ 1, 2, 4, 1 });
+    REQUIRE (treeAnalysis.fanOutHistogram == std::map<uint64_t, uint64_t>{ { 0, 4 }, { 1, 1 }, { 2, 3 } });
+    REQUIRE (treeAnalysis.heapBytes >= 8 * sizeof (int) + 8 * sizeof (uint64_t));
+    REQUIRE (treeAnalysis.valueBytes == 8 * sizeof (int));
+    REQUIRE (treeAnalysis.childrenOffsetEndBytes[0] == 8);
+    REQUIRE (treeAnalysis.childrenOffsetEndBytes[3] == 64);
+    REQUIRE (treeAnalysis.childrenAreSorted);
+    // 6 children in groups of 2 take 1 + 2 comparisons per group with a linear search. 7 has no siblings
+    REQUIRE (treeAnalysis.averageComparisonsLinearSearch == Approx (10.0 / 7.0));
+    REQUIRE (treeAnalysis.averageComparisonsBinarySearch == Approx (13.0 / 7.0));
+    REQUIRE (treeAnalysis.averageBytesScannedLinearSearch == Approx (10.0 / 7.0 * sizeof (int)));
+  }
+  SECTION ("views and FixedSmallMemoryTree own no heap memory")
+  {
+    REQUIRE (analyze (SmallMemoryTreeView<int>{ smallMemoryTree }).value ().heapBytes == 0);
+    auto const &fixedSmallMemoryTree = FixedSmallMemoryTree<int, 3>{ TreeLiteral<int>{ 0, { { 2 }, { 1 } } } };
+    auto const treeAnalysis = analyze (fixedSmallMemoryTree).value ();
+    REQUIRE (treeAnalysis.heapBytes == 0);
+    REQUIRE (treeAnalysis.nodeCountPerLevel == std::vector<uint64_t>{ 1, 2 });
+    REQUIRE_FALSE (treeAnalysis.childrenAreSorted);
+  }
+  SECTION ("childrenOffsetEnds which do not fit")
+  {
+    auto const &bigTree = SmallMemoryTree<int>{ std::vector<int> (300, 1), std::vector<uint64_t> (300, 299) };
+    auto const treeAnalysis = analyze (bigTree).value ();
+    REQUIRE (treeAnalysis.maxFanOut () == 299);
+    REQUIRE_FALSE (treeAnalysis.childrenOffsetEndBytes[0]);
+    REQUIRE (treeAnalysis.childrenOffsetEndBytes[1] == 600);
+  }
+  SECTION ("empty tree")
+  {
+    auto const treeAnalysis = analyze (SmallMemoryTree<int>{}).value ();
+    REQUIRE (treeAnalysis.nodeCount == 0);
+    REQUIRE (treeAnalysis.depth == 0);
+    REQUIRE (treeAnalysis.averageComparisonsLinearSearch == 0);
+  }
+  SECTION ("broken childrenOffsetEnds")
+  {
+    auto const &brokenTree = SmallMemoryTreeView<int>{ std::span<int const>{ smallMemoryTree.getValues () }.first (2), std::span<uint64_t const>{ smallMemoryTree.getChildrenOffsetEnds () }.first (2) };
+    REQUIRE_FALSE (analyze (brokenTree));
+  }
+}
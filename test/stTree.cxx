@@ -1,3 +1,4 @@
+#include "small_memory_tree/parallelSmallMemoryTree.hxx"
 #include "small_memory_tree/stTree.hxx"
 #include <catch2/catch.hpp>
 using namespace small_memory_tree;
@@ -15,4 +16,32 @@ TEST_CASE ("generateStTree")
   auto smallMemoryTree = SmallMemoryTree<int>{ StTreeAdapter{ stTree } };
   auto testSmallMemoryTree = SmallMemoryTree<int>{ StTreeAdapter{ generateStTree (smallMemoryTree).value () } };
   REQUIRE (testSmallMemoryTree == smallMemoryTree);
-}
\ No newline at end of file
+}
+TEST_CASE ("generateStTree from SmallMemoryTreeView")
+{
+  auto stTree = st_tree::tree<int>{};
+  stTree.insert (0);
+  stTree.root ().insert (1);
+  stTree.root ().insert (2);
+  stTree.root ()[0].insert (3);
+  auto smallMemoryTree = SmallMemoryTree<int>{ StTreeAdapter{ stTree } };
+  REQUIRE (generateStTree (SmallMemoryTreeView{ smallMemoryTree }).value () == stTree);
+}
+TEST_CASE ("generateSmallMemoryTreeParallel from StTreeAdapter")
+{
+  auto stTree = st_tree::tree<int>{};
+  stTree.insert (0);
+  stTree.root ().insert (1);
+  stTree.root ().insert (2);
+  stTree.root ()[0].insert (3);
+  stTree.root ()[0].insert (4);
+  stTree.root ()[1].insert (5);
+  stTree.root ()[1].insert (6);
+  stTree.root ()[1][1].insert (7);
+  REQUIRE (generateSmallMemoryTreeParallel<int> (StTreeAdapter{ stTree }, 4, 1) == SmallMemoryTree<int>{ StTreeAdapter{ stTree } });
+}
+TEST_CASE ("generateStTree from an empty tree")
+{
+  REQUIRE (generateStTree (SmallMemoryTree<int>{}).error () == ApiError::OutOfRange);
+  REQUIRE (generateStTree (SmallMemoryTreeView<int>{ std::span<int const>{}, std::span<uint64_t const>{} }).error () == ApiError::OutOfRange);
+}
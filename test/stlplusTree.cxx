@@ -1,3 +1,4 @@
+#include "small_memory_tree/parallelSmallMemoryTree.hxx"
 #include "small_memory_tree/stlplusTree.hxx"
 #include <catch2/catch.hpp>
 using namespace small_memory_tree;
@@ -15,4 +16,32 @@ TEST_CASE ("generateStlplusTree")
   auto smallMemoryTree = SmallMemoryTree<int>{ StlplusTreeAdapter{ nTree } };
   auto testSmallMemoryTree = SmallMemoryTree<int>{ StlplusTreeAdapter{ generateStlplusTree (smallMemoryTree).value () } };
   REQUIRE (testSmallMemoryTree == smallMemoryTree);
-}
\ No newline at end of file
+}
+TEST_CASE ("generateStlplusTree from SmallMemoryTreeView")
+{
+  stlplus::ntree<int> nTree{};
+  auto root = nTree.insert (0);
+  auto rootChild0 = nTree.append (root, 1);
+  nTree.append (root, 2);
+  nTree.append (rootChild0, 3);
+  auto smallMemoryTree = SmallMemoryTree<int>{ StlplusTreeAdapter{ nTree } };
+  REQUIRE (generateStlplusTree (SmallMemoryTreeView{ smallMemoryTree }).value () == nTree);
+}
+TEST_CASE ("generateSmallMemoryTreeParallel from StlplusTreeAdapter")
+{
+  stlplus::ntree<int> nTree{};
+  auto root = nTree.insert (0);
+  auto rootChild0 = nTree.append (root, 1);
+  auto rootChild1 = nTree.append (root, 2);
+  nTree.append (rootChild0, 3);
+  nTree.append (rootChild0, 4);
+  nTree.append (rootChild1, 5);
+  auto myChild = nTree.append (rootChild1, 6);
+  nTree.append (myChild, 7);
+  REQUIRE (generateSmallMemoryTreeParallel<int> (StlplusTreeAdapter{ nTree }, 4, 1) == SmallMemoryTree<int>{ StlplusTreeAdapter{ nTree } });
+}
+TEST_CASE ("generateStlplusTree from an empty tree")
+{
+  REQUIRE (generateStlplusTree (SmallMemoryTree<int>{}).error () == ApiError::OutOfRange);
+  REQUIRE (generateStlplusTree (SmallMemoryTreeView<int>{ std::span<int const>{}, std::span<uint64_t const>{} }).error () == ApiError::OutOfRange);
+}
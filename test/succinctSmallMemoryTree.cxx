@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2024 Waldemar Schneider (w-schneider1987 at web dot de)
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file LICENSE.md or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "small_memory_tree/eytzingerIndex.hxx"
+#include "small_memory_tree/succinctSmallMemoryTree.hxx"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace small_memory_tree;
+
+TEST_CASE ("EliasFanoSequence")
+{
+  SECTION ("empty") { REQUIRE (EliasFanoSequence{ std::vector<uint64_t>{} }.empty ()); }
+  SECTION ("childrenOffsetEnds needs about 2 bits per element")
+  {
+    auto childrenOffsetEnds = std::vector<uint64_t> (100000);
+    std::iota (childrenOffsetEnds.begin (), childrenOffsetEnds.end (), uint64_t{});
+    auto const &eliasFanoSequence = EliasFanoSequence{ childrenOffsetEnds };
+    REQUIRE (std::ranges::equal (std::views::iota (uint64_t{}, eliasFanoSequence.size ()) | std::views::transform ([&] (uint64_t i) { return eliasFanoSequence[i]; }), childrenOffsetEnds));
+    REQUIRE (eliasFanoSequence.memoryUsage () * 8 < childrenOffsetEnds.size () * 3);
+  }
+  SECTION ("big gaps use low bits")
+  {
+    auto sequence = std::vector<uint64_t>{};
+    for (auto i = uint64_t{}; i < 1000; ++i)
+      {
+        sequence.push_back (i * i * 1000 + i % 7);
+      }
+    sequence.push_back (sequence.back ());
+    auto const &eliasFanoSequence = EliasFanoSequence{ sequence };
+    REQUIRE (eliasFanoSequence.size () == sequence.size ());
+    for (auto i = uint64_t{}; i < sequence.size (); ++i)
+      {
+        REQUIRE (eliasFanoSequence[i] == sequence.at (i));
+      }
+  }
+  SECTION ("childrenOffsetEnds of nodes with many children")
+  {
+    // node 5 has 40000 children, every 50th node has 600 children and the other nodes have one child until every node is a child.
+    // Node 5 creates a sparse block, the nodes with 600 children explicit subblocks
+    auto childrenCounts = std::vector<uint64_t> (200000);
+    auto childrenCountSum = uint64_t{};
+    for (auto i = uint64_t{}; childrenCountSum < childrenCounts.size () - 1; ++i)
+      {
+        auto const &childrenCount = (i == 5) ? uint64_t{ 40000 } : ((i % 50 == 0) ? uint64_t{ 600 } : uint64_t{ 1 });
+        childrenCounts.at (i) = std::min (childrenCount, childrenCounts.size () - 1 - childrenCountSum);
+        childrenCountSum += childrenCounts.at (i);
+      }
+    auto childrenOffsetEnds = std::vector<uint64_t> (childrenCounts.size ());
+    std::partial_sum (childrenCounts.begin (), childrenCounts.end (), childrenOffsetEnds.begin ());
+    auto const &eliasFanoSequence = EliasFanoSequence{ childrenOffsetEnds };
+    for (auto i = uint64_t{}; i < childrenOffsetEnds.size (); ++i)
+      {
+        REQUIRE (eliasFanoSequence[i] == childrenOffsetEnds.at (i));
+      }
+  }
+  SECTION ("decreasing sequence")
+  {
+    REQUIRE_THROWS_AS (EliasFanoSequence (std::vector<uint64_t>{ 2, 1 }), std::logic_error);
+    // the bit arrays would be sized for the last element which is much smaller than the first. std::out_of_range is a std::logic_error too so the message gets checked
+    REQUIRE_THROWS_WITH (EliasFanoSequence (std::vector<uint64_t>{ 1000000, 1, 2, 3 }), "EliasFanoSequence needs a non decreasing sequence");
+  }
+}
+
+TEST_CASE ("SuccinctSmallMemoryTree")
+{
+  auto const &smallMemoryTree = SmallMemoryTree<int, uint8_t>{ std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }, std::vector<uint8_t>{ 2, 4, 6, 6, 6, 6, 7, 7 } };
+  auto const &succinctSmallMemoryTree = SuccinctSmallMemoryTree<int>{ smallMemoryTree };
+  SECTION ("same result as SmallMemoryTree")
+  {
+    for (auto index = uint64_t{}; index <= smallMemoryTree.getValues ().size (); ++index)
+      {
+        REQUIRE (internals::childrenBeginAndEndIndex (succinctSmallMemoryTree, index) == internals::childrenBeginAndEndIndex (smallMemoryTree, index));
+      }
+    REQUIRE (calcChildrenForPath (succinctSmallMemoryTree, { 0, 2, 6 }).value () == calcChildrenForPath (smallMemoryTree, { 0, 2, 6 }).value ());
+    REQUIRE (calcChildrenForPath (succinctSmallMemoryTree, { 0, 2, 6, 7, 42 }).error () == ApiError::PathTooLong);
+    REQUIRE (calcChildrenForPath (succinctSmallMemoryTree, { 0, 3 }).error () == ApiError::PathDoesNotMatch);
+  }
+  SECTION ("from values and childrenOffsetEnds") { REQUIRE (SuccinctSmallMemoryTree<int>{ smallMemoryTree.getValues (), smallMemoryTree.getChildrenOffsetEnds () } == succinctSmallMemoryTree); }
+  SECTION ("wide tree with EytzingerIndex")
+  {
+    auto values = std::vector<uint64_t> (10001);
+    std::iota (values.begin () + 1, values.end (), uint64_t{});
+    auto const &wideSmallMemoryTree = SuccinctSmallMemoryTree<uint64_t>{ values, std::vector<uint64_t> (values.size (), values.size () - 1) };
+    auto const &eytzingerIndex = EytzingerIndex<uint64_t>{ wideSmallMemoryTree };
+    REQUIRE (calcChildrenIndexForPath (wideSmallMemoryTree, { 0, 9999 }, eytzingerIndex).value () == std::tuple<uint64_t, uint64_t>{ 10001, 10001 });
+    REQUIRE (calcChildrenSpanForPath (wideSmallMemoryTree, { 0 }).value ().size () == 10000);
+  }
+}